@@ -0,0 +1,196 @@
+// Annotated source page for very long files, drawn a screenful at a time.
+//
+// The lines of the file and their statistics are written by the profiling
+// package into 'NAME.html.js', which calls coveragePage(data). Only the rows
+// which can be seen are in the document, and sorting works on the data
+// rather than the table, so long files stay quick to scroll and sort. See
+// writeVirtualCoveragePage in src/coverage_html.h for the format.
+(function() {
+  "use strict";
+
+  var classes = ["ignore", "exec", "missed"];
+  var extra = 20;
+  var page, order, box, tbody, headers = [], columns;
+  var rowheight = 20, sortcolumn = -1, reversed = false, drawQueued = false;
+
+  var style = document.createElement("style");
+  style.textContent =
+    "body.virtual { margin: 0; height: 100vh; display: flex; flex-direction: column; }\n" +
+    "#coverage { flex: 1; overflow: auto; }\n" +
+    "#coverage table { table-layout: fixed; width: 100%; }\n" +
+    "#coverage th { position: sticky; top: 0; cursor: pointer; }\n" +
+    "#coverage td { white-space: nowrap; overflow: hidden; text-overflow: ellipsis; }\n" +
+    "#coverage tt { white-space: pre; }\n";
+  document.head.appendChild(style);
+
+  function separators(n) {
+    return String(n).replace(/\B(?=(\d{3})+(?!\d))/g, ",");
+  }
+
+  function number(values) {
+    return function(i) {
+      return values[i] < 0 ? "" : separators(values[i]);
+    };
+  }
+
+  function links(html) {
+    return function(i) {
+      return html[i + 1] || "";
+    };
+  }
+
+  // Each column has a title, a width, the text or HTML of each cell, and
+  // how to sort it (if it can be sorted)
+  function makeColumns() {
+    var cols = [{ title: "Line", width: "5em", text: function(i) { return String(i + 1); },
+                  key: function(i) { return i; } }];
+    if (page.timing) {
+      cols.push({ title: "Execs", width: "7em", text: number(page.execs),
+                  key: function(i) { return page.execs[i]; } });
+      cols.push({ title: "Time", width: "7em", text: number(page.times),
+                  key: function(i) { return page.times[i]; } });
+      cols.push({ title: "Time+Childs", width: "8em", text: number(page.totals),
+                  key: function(i) { return page.totals[i]; } });
+    }
+    cols.push({ title: "Code", width: page.timing ? "50%" : "auto", code: true,
+                text: function(i) { return page.lines[i]; },
+                key: function(i) { return page.lines[i]; } });
+    if (page.timing) {
+      cols.push({ title: "Called Functions", width: "25%", html: links(page.called) });
+      cols.push({ title: "Called From", width: "25%", html: links(page.callers) });
+    }
+    return cols;
+  }
+
+  function row(i) {
+    var tr = document.createElement("tr");
+    tr.className = classes[page.kinds.charCodeAt(i) - 48];
+    for (var c = 0; c < columns.length; c++) {
+      var td = document.createElement("td");
+      var col = columns[c];
+      if (col.html) {
+        td.innerHTML = col.html(i);
+      } else if (col.code) {
+        var tt = document.createElement("tt");
+        tt.textContent = col.text(i).replace(/\t/g, "        ");
+        td.appendChild(tt);
+      } else {
+        td.textContent = col.text(i);
+      }
+      tr.appendChild(td);
+    }
+    return tr;
+  }
+
+  function spacer(height) {
+    var tr = document.createElement("tr");
+    tr.style.height = height + "px";
+    return tr;
+  }
+
+  function queueDraw() {
+    if (!drawQueued) {
+      drawQueued = true;
+      window.requestAnimationFrame(draw);
+    }
+  }
+
+  function draw() {
+    drawQueued = false;
+    var first = Math.max(0, Math.floor(box.scrollTop / rowheight) - extra);
+    var last = Math.min(order.length, Math.ceil((box.scrollTop + box.clientHeight) / rowheight) + extra);
+    var rows = document.createDocumentFragment();
+    rows.appendChild(spacer(first * rowheight));
+    // Keep the colours of the rows, which depend on their position
+    if (first % 2 === 0) {
+      rows.appendChild(spacer(0));
+    }
+    for (var k = first; k < last; k++) {
+      rows.appendChild(row(order[k]));
+    }
+    rows.appendChild(spacer((order.length - last) * rowheight));
+    tbody.textContent = "";
+    tbody.appendChild(rows);
+
+    // Use the real height of the rows, once we can see one
+    if (last > first) {
+      var height = tbody.children[first % 2 === 0 ? 2 : 1].offsetHeight;
+      if (height > 0 && height !== rowheight) {
+        rowheight = height;
+        queueDraw();
+      }
+    }
+  }
+
+  function sort(c) {
+    var key = columns[c].key;
+    reversed = (sortcolumn === c) ? !reversed : false;
+    sortcolumn = c;
+    order.sort(function(a, b) {
+      var x = key(a), y = key(b);
+      var diff = x < y ? -1 : (x > y ? 1 : a - b);
+      return reversed ? -diff : diff;
+    });
+    for (var h = 0; h < headers.length; h++) {
+      headers[h].className = columns[h].key ? "" : "sorttable_nosort";
+    }
+    headers[c].className = reversed ? "sorttable_sorted_reverse" : "sorttable_sorted";
+    queueDraw();
+  }
+
+  // Follow links to "#lineN" from other pages, as those rows may not be
+  // in the document yet
+  function showLine() {
+    var match = /^#line(\d+)$/.exec(window.location.hash);
+    if (match) {
+      var k = order.indexOf(parseInt(match[1], 10) - 1);
+      if (k >= 0) {
+        box.scrollTop = k * rowheight;
+        queueDraw();
+      }
+    }
+  }
+
+  window.coveragePage = function(data) {
+    page = data;
+    if (page.timing) {
+      page.execs = new Float64Array(page.execs);
+      page.times = new Float64Array(page.times);
+      page.totals = new Float64Array(page.totals);
+    }
+    order = new Int32Array(page.lines.length);
+    for (var i = 0; i < order.length; i++) {
+      order[i] = i;
+    }
+    columns = makeColumns();
+
+    box = document.getElementById("coverage");
+    var table = document.createElement("table");
+    table.className = "sortable";
+    var head = document.createElement("tr");
+    columns.forEach(function(col, c) {
+      var th = document.createElement("th");
+      th.textContent = col.title;
+      th.style.width = col.width;
+      if (col.key) {
+        th.addEventListener("click", function() { sort(c); });
+      } else {
+        th.className = "sorttable_nosort";
+      }
+      headers.push(th);
+      head.appendChild(th);
+    });
+    var thead = document.createElement("thead");
+    thead.appendChild(head);
+    tbody = document.createElement("tbody");
+    table.appendChild(thead);
+    table.appendChild(tbody);
+    box.appendChild(table);
+
+    box.addEventListener("scroll", queueDraw);
+    window.addEventListener("resize", queueDraw);
+    window.addEventListener("hashchange", showLine);
+    draw();
+    showLine();
+  };
+})();
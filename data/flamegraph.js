@@ -0,0 +1,269 @@
+// Interactive flame graph for large profiles, drawn on a canvas.
+//
+// The call tree is written by the profiling package into 'data.js' and
+// 'chunks/N.js'. Each file calls flameChunk(N, subtrees). Chunks are only
+// loaded when their part of the tree becomes wide enough to see, usually
+// after zooming in. See FlameChunkWriter in src/flamegraph.h for the format.
+(function() {
+  "use strict";
+
+  var rowheight = 16;
+  var chunks = {}, waiting = {};
+  var canvas, ctx, tooltip, searchbox, statustext;
+  var root = null, focus = null, search = null, top = 0;
+  var hits = [], colours = [], charwidth = 7, drawQueued = false;
+
+  function convert(arr, parent) {
+    var node = { f: arr[0], v: arr[1], p: parent, c: null, chunk: -1, k: 0 };
+    if (arr.length === 3) {
+      node.c = arr[2].map(function(a) { return convert(a, node); });
+    } else if (arr.length === 4) {
+      node.chunk = arr[2];
+      node.k = arr[3];
+    }
+    return node;
+  }
+
+  function attach(node) {
+    node.c = chunks[node.chunk][node.k].map(function(a) { return convert(a, node); });
+    node.chunk = -1;
+  }
+
+  window.flameChunk = function(id, data) {
+    chunks[id] = data;
+    var nodes = waiting[id] || [];
+    delete waiting[id];
+    for (var i = 0; i < nodes.length; i++) {
+      attach(nodes[i]);
+    }
+    queueDraw();
+  };
+
+  function load(node) {
+    if (chunks[node.chunk]) {
+      attach(node);
+      return;
+    }
+    if (waiting[node.chunk]) {
+      if (waiting[node.chunk].indexOf(node) < 0) {
+        waiting[node.chunk].push(node);
+      }
+      return;
+    }
+    waiting[node.chunk] = [node];
+    var script = document.createElement("script");
+    script.src = "chunks/" + node.chunk + ".js";
+    document.head.appendChild(script);
+  }
+
+  function name(node) {
+    return node.f < 0 ? "all" : flameData.functions[node.f];
+  }
+
+  // The same colours as the SVG flame graphs
+  function colour(node) {
+    if (node.f < 0) {
+      return "rgb(220,160,40)";
+    }
+    if (!colours[node.f]) {
+      var n = name(node), h = 2166136261;
+      for (var i = 0; i < n.length; i++) {
+        h ^= n.charCodeAt(i);
+        h = Math.imul(h, 16777619) >>> 0;
+      }
+      colours[node.f] = "rgb(" + Math.floor(205 + 50 * ((h >>> 16) & 255) / 255) + "," +
+                        Math.floor(230 * (h & 255) / 255) + "," +
+                        Math.floor(55 * ((h >>> 8) & 255) / 255) + ")";
+    }
+    return colours[node.f];
+  }
+
+  function fit(text, width) {
+    var chars = Math.floor(width / charwidth);
+    if (chars < 3) {
+      return "";
+    }
+    return text.length <= chars ? text : text.substring(0, chars - 2) + "..";
+  }
+
+  function queueDraw() {
+    if (canvas && !drawQueued) {
+      drawQueued = true;
+      window.requestAnimationFrame(draw);
+    }
+  }
+
+  function frame(node, x, width, depth) {
+    var y = (depth - top) * rowheight;
+    if (y < 0) {
+      return;
+    }
+    var text = name(node);
+    ctx.fillStyle = search && search.test(text) ? "rgb(230,0,230)" : colour(node);
+    ctx.fillRect(x, y, Math.max(width - 1, 0.5), rowheight - 1);
+    if (width > 6 * charwidth) {
+      ctx.fillStyle = "#000";
+      ctx.fillText(fit(text, width - 6), x + 3, y + 12);
+    }
+    hits.push({ x: x, y: y, width: width, node: node });
+  }
+
+  // Only frames which are wide enough to see, and are inside the window,
+  // are drawn or loaded
+  function subtree(node, x, scale, depth, rows) {
+    var width = node.v * scale;
+    if (width < 0.5 || depth - top >= rows) {
+      return;
+    }
+    frame(node, x, width, depth);
+    if (node.chunk >= 0) {
+      if (width >= 2) {
+        load(node);
+      }
+      return;
+    }
+    if (!node.c) {
+      return;
+    }
+    // Time spent in this frame itself comes first, as in the SVG flame graphs
+    var self = node.v;
+    for (var i = 0; i < node.c.length; i++) {
+      self -= node.c[i].v;
+    }
+    x += self * scale;
+    for (var j = 0; j < node.c.length; j++) {
+      subtree(node.c[j], x, scale, depth + 1, rows);
+      x += node.c[j].v * scale;
+    }
+  }
+
+  function draw() {
+    drawQueued = false;
+    canvas.width = canvas.clientWidth;
+    canvas.height = window.innerHeight - canvas.getBoundingClientRect().top;
+    ctx.font = "12px Verdana, sans-serif";
+    charwidth = ctx.measureText("abcdefghijklmnopqrstuvwxyz").width / 26;
+    ctx.clearRect(0, 0, canvas.width, canvas.height);
+    hits = [];
+    if (!focus || focus.v === 0) {
+      return;
+    }
+    var rows = Math.ceil(canvas.height / rowheight), chain = [];
+    for (var n = focus; n; n = n.p) {
+      chain.unshift(n);
+    }
+    // The callers of the zoomed frame are drawn full width, and faded
+    ctx.globalAlpha = 0.5;
+    for (var d = 0; d < chain.length - 1; d++) {
+      frame(chain[d], 0, canvas.width, d);
+    }
+    ctx.globalAlpha = 1;
+    subtree(focus, 0, canvas.width / focus.v, chain.length - 1, rows);
+  }
+
+  function percent(v, total) {
+    return (100 * v / total).toFixed(2) + "%";
+  }
+
+  function hit(e) {
+    var rect = canvas.getBoundingClientRect(), x = e.clientX - rect.left, y = e.clientY - rect.top;
+    for (var i = hits.length - 1; i >= 0; i--) {
+      var h = hits[i];
+      if (x >= h.x && x < h.x + h.width && y >= h.y && y < h.y + rowheight) {
+        return h.node;
+      }
+    }
+    return null;
+  }
+
+  // The share of the loaded tree whose frames match the search
+  function matchedWeight(node) {
+    if (search.test(name(node))) {
+      return node.v;
+    }
+    var total = 0;
+    if (node.c) {
+      for (var i = 0; i < node.c.length; i++) {
+        total += matchedWeight(node.c[i]);
+      }
+    }
+    return total;
+  }
+
+  function setSearch() {
+    search = null;
+    statustext.textContent = "";
+    if (searchbox.value !== "") {
+      try {
+        search = new RegExp(searchbox.value);
+      } catch (err) {
+        statustext.textContent = err.message;
+        return;
+      }
+      statustext.textContent = "Matched: " + percent(matchedWeight(root), root.v) +
+                               " (of the parts of the graph loaded so far)";
+    }
+    queueDraw();
+  }
+
+  function zoom(node) {
+    focus = node;
+    top = 0;
+    queueDraw();
+  }
+
+  function init() {
+    canvas = document.getElementById("flame");
+    ctx = canvas.getContext("2d");
+    tooltip = document.getElementById("tooltip");
+    searchbox = document.getElementById("search");
+    statustext = document.getElementById("status");
+
+    root = { f: -1, v: flameData.total, p: null, c: null, chunk: 0, k: 0 };
+    load(root);
+    focus = root;
+
+    canvas.addEventListener("mousemove", function(e) {
+      var node = hit(e);
+      if (!node) {
+        tooltip.style.display = "none";
+        return;
+      }
+      tooltip.textContent = name(node) + "\n" + node.v + " " + (flameData.unit || "ticks") + ", " +
+                            percent(node.v, root.v) + " of all, " +
+                            percent(node.v, focus.v) + " of zoomed frame";
+      tooltip.style.left = (e.clientX + 12) + "px";
+      tooltip.style.top = (e.clientY + 12) + "px";
+      tooltip.style.display = "block";
+    });
+    canvas.addEventListener("mouseleave", function() {
+      tooltip.style.display = "none";
+    });
+    canvas.addEventListener("click", function(e) {
+      var node = hit(e);
+      if (node) {
+        zoom(node);
+      }
+    });
+    canvas.addEventListener("wheel", function(e) {
+      top = Math.max(0, top + (e.deltaY > 0 ? 3 : -3));
+      e.preventDefault();
+      queueDraw();
+    });
+    document.getElementById("reset").addEventListener("click", function() {
+      zoom(root);
+    });
+    searchbox.addEventListener("change", setSearch);
+    window.addEventListener("keydown", function(e) {
+      if (e.keyCode === 27) {
+        searchbox.value = "";
+        setSearch();
+        zoom(root);
+      }
+    });
+    window.addEventListener("resize", queueDraw);
+    queueDraw();
+  }
+
+  window.addEventListener("load", init);
+})();
@@ -10,7 +10,7 @@
 
 #! @Section Reading line-by-line profiles
 
-#! @Arguments filename
+#! @Arguments filename [, options]
 #! @Description
 #!   Read <A>filename</A>, a line-by-line profile which was previously generated
 #!   by &GAP;, using the <Ref Func="ProfileLineByLine" BookName="ref"/>
@@ -18,6 +18,115 @@
 #!   A parsed profile can be transformed into a human-readable form using either
 #!   <Ref Func="OutputAnnotatedCodeCoverageFiles"/> or
 #!   <Ref Func="OutputFlameGraph"/>
+#!   <P/>
+#!   The optional argument <A>options</A> is a record. The following options
+#!   are supported:
+#!     * <C>timeline_ticks</C>: a positive integer. If given, the runtime of
+#!       the profile is split into buckets of this many ticks (ticks are
+#!       microseconds), and the profile gains a component <C>timeline</C>.
+#!       This is a record with components <C>bucket_ticks</C>, <C>buckets</C>
+#!       (the number of buckets), <C>functions</C> and <C>files</C>, and two
+#!       matrices <C>function_ticks</C> and <C>file_ticks</C>, which have
+#!       one row for each function (or file) and one column for each bucket.
+#!     * <C>timeline_seconds</C>: as <C>timeline_ticks</C>, but giving the
+#!       width of each bucket in seconds. This cannot be used with profiles
+#!       which record memory use rather than time.
+#!     * <C>squash</C>: a boolean. If <K>true</K>, functions which directly
+#!       call themselves are merged with their caller in
+#!       <C>stack_runtimes</C>, as by <Ref Func="SquashLineByLineProfile"/>.
+#!     * <C>max_tree_nodes</C>: a positive integer. Limits the number of
+#!       nodes in the tree of function calls which is used to build
+#!       <C>stack_runtimes</C>, to bound the memory used when reading profiles
+#!       of deeply recursive code. Whenever the tree grows too large, the
+#!       coldest subtrees (those with the fewest ticks, and then the fewest
+#!       calls) are merged into a single child called <C>[other]</C> of their
+#!       parent. The total number of ticks is unchanged, and any call stack
+#!       which takes more than <C>reader_stats.prune_threshold</C> ticks (see
+#!       below) is reported exactly. Functions which are running cannot be
+#!       merged, so very deep recursion may still exceed this limit.
+#!     * <C>trace_file</C>: a filename. If given, the order in which
+#!       functions were called is written to this file, in the Chrome Trace
+#!       Event Format, which can be viewed with Perfetto
+#!       (<URL>https://ui.perfetto.dev</URL>). The file is written while the
+#!       profile is read, and is compressed with <C>gzip</C> if its name ends
+#!       in <C>.gz</C>. Times are given in ticks.
+#!     * <C>trace_min_ticks</C>: a positive integer, which must be given
+#!       with <C>trace_file</C>. Function calls which take fewer than this
+#!       many ticks are left out of the trace, and their time is shown as
+#!       part of their caller. This keeps traces of long computations small
+#!       enough to view.
+#!     * <C>line_stacks</C>: a boolean. If <K>true</K>, the profile gains a
+#!       component <C>line_stack_runtimes</C>, in the same format as
+#!       <C>stack_runtimes</C>, in which functions called from different
+#!       lines are kept apart. The name of each function is followed by the
+#!       file and line it was called from, for example
+#!       <C>f [from file.g:12]</C>. This shows which loop of a large function
+#!       is slow, and is drawn by the option <C>lines</C> of
+#!       <Ref Func="OutputFlameGraph"/>. The profile also gains a component
+#!       <C>line_samples</C>, with an entry <C>[locations, ticks]</C> for each
+#!       line which ran in each node of that tree. <C>locations</C> is a list
+#!       of pairs <C>[function, line]</C>, one for each function in the
+#!       stack, from the outermost in, giving the line running in that
+#!       function: the line being executed in the last function, and the line
+#!       which called the next function in the others. This is used by
+#!       <Ref Func="OutputPprofProfile"/>.
+#!     * <C>phase_timing</C>: a boolean. If <K>true</K>, the time spent
+#!       reading, parsing and collecting statistics from each line of the
+#!       profile is measured separately (see <C>reader_stats</C> below).
+#!       This reads the clock three times for every line, so slows down
+#!       reading large profiles.
+#!   <P/>
+#!   The component <C>stack_runtimes</C> of the result describes the tree of
+#!   function calls. It has an entry <C>[stack, ticks, calls]</C> for each
+#!   node of the tree, where <C>stack</C> is the list of functions on the
+#!   path from the top level to that node, <C>ticks</C> is the time spent in
+#!   the last function of <C>stack</C> (not counting the functions it
+#!   called) and <C>calls</C> is the number of times that function was
+#!   called from this stack. This is also recorded in coverage profiles,
+#!   which have no time.
+#!   <P/>
+#!   The component <C>functions</C> of the result is a list of all the
+#!   functions which were called, and <C>call_graph.edges</C> is a list of the
+#!   edges of the graph of function calls. Each edge is a list
+#!   <C>[caller, callee, calls, ticks, self_ticks]</C>, where
+#!   <C>caller</C> and <C>callee</C> are positions in <C>functions</C>
+#!   (<C>caller</C> is 0 for functions called from the top level),
+#!   <C>calls</C> is the number of times <C>caller</C> called <C>callee</C>,
+#!   <C>ticks</C> is the time spent in those calls (counting recursive calls
+#!   only once) and <C>self_ticks</C> is the time spent executing the code of
+#!   <C>callee</C> itself in those calls. The component
+#!   <C>line_function_call_stats</C> matches <C>line_function_calls</C>, and
+#!   gives a pair <C>[calls, ticks]</C> for each function called from each line.
+#!   <P/>
+#!   The component <C>function_durations</C> matches <C>functions</C>. It gives
+#!   a list <C>[calls, p50, p90, p99, max]</C> for each function: the number
+#!   of calls, and the 50th, 90th and 99th percentiles and the maximum of the
+#!   time taken by each call, including the functions it called. The
+#!   percentiles are found from a histogram, so they are accurate to about
+#!   6%. Calls still running at the end of the profile are counted up to the
+#!   end of the profile.
+#!   <P/>
+#!   The <C>info</C> component of the result contains a record
+#!   <C>reader_stats</C>, which describes the work done while reading the
+#!   profile. It contains the number of records of each type read
+#!   (<C>read_records</C>, <C>exec_records</C>, <C>into_fun_records</C>,
+#!   <C>out_fun_records</C>, <C>string_id_records</C> and <C>info_records</C>),
+#!   the number of <C>lines</C> and <C>bytes_read</C>, the number of
+#!   <C>damaged_lines</C> which could not be parsed and the
+#!   <C>max_stack_depth</C> of function calls. It contains the number of nodes
+#!   in the final tree of function calls (<C>tree_nodes</C>), the largest
+#!   that tree became (<C>peak_tree_nodes</C>), the number of nodes removed to
+#!   stay within <C>max_tree_nodes</C> (<C>pruned_nodes</C>) and the largest
+#!   number of ticks in a removed subtree (<C>prune_threshold</C>). It
+#!   contains the number of events written to <C>trace_file</C>
+#!   (<C>trace_events</C>). It also gives the time, in
+#!   nanoseconds, spent in each phase of reading: <C>loop_ns</C> (going
+#!   through the file), <C>build_ns</C> (gathering the results) and
+#!   <C>convert_ns</C> (creating &GAP; objects). If the option
+#!   <C>phase_timing</C> was given, <C>loop_ns</C> is split into
+#!   <C>read_ns</C> (reading, and decompressing, the file), <C>parse_ns</C>
+#!   (parsing JSON) and <C>aggregate_ns</C> (collecting statistics), which
+#!   are otherwise 0.
 DeclareGlobalFunction( "ReadLineByLineProfile" );
 
 #! @Arguments filenames
@@ -29,6 +138,136 @@ DeclareGlobalFunction( "ReadLineByLineProfile" );
 #!   or files previously parsed by <Ref Func="ReadLineByLineProfile"/>.
 DeclareGlobalFunction( "MergeLineByLineProfiles" );
 
+#! @Arguments profile
+#! @Description
+#!   Returns a copy of <A>profile</A> where recursive function calls are
+#!   squashed, so functions which directly call themselves are merged with
+#!   their caller in <C>stack_runtimes</C>. The time spent in the recursive
+#!   calls is added to the caller.
+#!   <P/>
+#!   <A>profile</A> should be either a profile previously read by
+#!   <Ref Func="ReadLineByLineProfile"/>,
+#!   or a string giving the filename of a profile.
+#!   The same result can be produced while reading a profile, by giving
+#!   the option <C>squash</C> to <Ref Func="ReadLineByLineProfile"/>.
+DeclareGlobalFunction( "SquashLineByLineProfile" );
+
+
+#! @Arguments before, after
+#! @Description
+#!   Compare two profiles, <A>before</A> and <A>after</A>, of the same
+#!   code, to find what became faster or slower. Each of <A>before</A> and
+#!   <A>after</A> should be either a profile previously read by
+#!   <Ref Func="ReadLineByLineProfile"/>, or a string giving the filename of
+#!   a profile.
+#!   <P/>
+#!   Returns a record with three components:
+#!     * <C>functions</C>: a list of records, one for each function, with
+#!       components <C>function</C>, <C>self_before</C>, <C>self_after</C>,
+#!       <C>incl_before</C> and <C>incl_after</C>. These give the ticks spent
+#!       in the function itself, and including the functions it called, in
+#!       each profile. Functions whose time increased the most come first.
+#!     * <C>lines</C>: a list of records, one for each line which took some
+#!       time, with components <C>filename</C>, <C>line</C> and the same
+#!       four times as <C>functions</C>, in the same order.
+#!     * <C>stacks</C>: a list of records, one for each stack of functions,
+#!       with components <C>stack</C>, <C>before</C> and <C>after</C> (the
+#!       ticks spent in that stack in each profile).
+#!   <P/>
+#!   Functions are matched by name, filename and starting line. If there is
+#!   no function in <A>after</A> which starts on the same line as a function
+#!   in <A>before</A>, then the function with the same name and file whose
+#!   starting line is closest is used, so small edits to a file do not stop
+#!   functions from matching. Each function in <A>after</A> is matched to at
+#!   most one function in <A>before</A>, so functions (such as several
+#!   functions without a name in one file) are never added together.
+DeclareGlobalFunction( "DiffLineByLineProfiles" );
+
+#! @Arguments profiles
+#! @Description
+#!   Find statistics for <A>profiles</A>, a list of profiles of repeated
+#!   runs of the same code. Each element of <A>profiles</A> should be either a
+#!   profile previously read by <Ref Func="ReadLineByLineProfile"/>, or a
+#!   string giving the filename of a profile.
+#!   <P/>
+#!   Returns a record with components <C>baseline_runs</C> (the number of
+#!   profiles), <C>functions</C> and <C>lines</C>. <C>functions</C> contains
+#!   a record for each function, with components <C>function</C>, <C>self</C>
+#!   (the ticks spent in the function itself) and <C>incl</C> (the ticks
+#!   spent in the function and the functions it called). <C>lines</C>
+#!   contains a record for each line, with components <C>filename</C>,
+#!   <C>line</C>, <C>self</C> and <C>incl</C>. Each of <C>self</C> and
+#!   <C>incl</C> is a record with components <C>mean</C>, <C>sd</C> (the
+#!   standard deviation) and <C>ci</C>: there is a 95% chance the true mean
+#!   is within <C>ci</C> of <C>mean</C>. The functions and lines which take
+#!   the most time come first.
+DeclareGlobalFunction( "LineByLineProfileStatistics" );
+
+#! @Arguments baseline, candidate
+#! @Description
+#!   Compare two lists of profiles, <A>baseline</A> and <A>candidate</A>,
+#!   each of repeated runs of the same code, to find which functions and lines
+#!   became slower or faster. The profiles are given as in
+#!   <Ref Func="LineByLineProfileStatistics"/>.
+#!   <P/>
+#!   Returns a record like <Ref Func="LineByLineProfileStatistics"/>, with an
+#!   extra component <C>candidate_runs</C>. Each record in <C>functions</C>
+#!   and <C>lines</C> has components <C>baseline</C> and <C>candidate</C>,
+#!   which each contain <C>self</C> and <C>incl</C> statistics for one list
+#!   of profiles, and the components <C>self_change</C> and
+#!   <C>incl_change</C>, the change in the mean ticks. The components
+#!   <C>self_significant</C> and <C>incl_significant</C> are <K>true</K> if
+#!   Welch's t-test finds the change is significant at the 95% level. This
+#!   needs at least two profiles in each list. Significant changes come
+#!   first, with the largest increases first.
+DeclareGlobalFunction( "CompareLineByLineProfileRuns" );
+
+#! @Arguments profile, budgets
+#! @Description
+#!   Check the profile <A>profile</A> (which may also be the filename of a
+#!   profile) against a list of performance budgets <A>budgets</A>. Each
+#!   budget is a record with exactly one of the following components, which
+#!   says which functions it applies to:
+#!     * <C>function</C>: the name of a function. All functions with this
+#!       name are counted together;
+#!     * <C>file</C>: a glob, such as <C>"*/lib/*.gi"</C>. All functions in
+#!       files matching the glob are counted together.
+#!
+#!   and any of the following limits:
+#!     * <C>max_self_ticks</C>: the time spent in the functions themselves;
+#!     * <C>max_incl_ticks</C>: the time spent in the functions and the
+#!       functions they called;
+#!     * <C>max_calls</C>: the number of calls to the functions;
+#!     * <C>max_share</C>: the share of the total time (between 0 and 1)
+#!       spent in the functions and the functions they called.
+#!
+#!   Returns a list of violations, which is empty if every budget was met.
+#!   Each violation is a record with components <C>budget</C> (the budget
+#!   which was exceeded), <C>limit</C> (the name of the limit, such as
+#!   <C>"max_calls"</C>), <C>maximum</C> and <C>value</C>.
+DeclareGlobalFunction( "AssertProfileBudget" );
+
+#! @Arguments diff [, filename]
+#! @Description
+#!   Draw a differential flame graph of <A>diff</A>, which was returned by
+#!   <Ref Func="DiffLineByLineProfiles"/>. The graph has the shape of the
+#!   'after' profile, with functions which became slower coloured red and
+#!   functions which became faster coloured blue. The colour is stronger the
+#!   more the time spent in the function itself changed, and this change is
+#!   also shown, as a percentage of the total time after, when hovering over
+#!   the function.
+#!   <P/>
+#!   The flame graph will be written to <A>filename</A> (or returned as a
+#!   string if <A>filename</A> is not present).
+DeclareGlobalFunction( "OutputDiffFlameGraph" );
+
+#! @Arguments diff, filename
+#! @Description
+#!   Write an HTML table to <A>filename</A> showing, for each function, the
+#!   time taken before and after, and how much this changed, for <A>diff</A>,
+#!   which was returned by <Ref Func="DiffLineByLineProfiles"/>. The functions
+#!   whose time increased the most are listed first.
+DeclareGlobalFunction( "OutputDiffRegressionTable" );
 
 
 #! @Section Generating flame graphs
@@ -51,12 +290,29 @@ DeclareGlobalFunction( "MergeLineByLineProfiles" );
 #!   The final (optional) argument is a record of options. Currently, the allowed
 #!   options are 'squash' (which is a boolean). If 'squash' is true then recursive
 #!   functions calls will be squashed, so the graph will not show recursive functions
-#!   calling themselves. The other allowed option is 'type', which can be "default"
+#!   calling themselves. The option 'type' can be "default"
 #!   (a standard flamegraph) or "reverse" (reverse the graph, showing the leaf functions
-#!   first)
+#!   first). The option 'minwidth' (default 0.1) leaves out functions drawn less
+#!   than this many pixels wide, which keeps the size of the graph bounded. The
+#!   option 'title' sets the title of the graph. If the option 'lines' is
+#!   <K>true</K>, each function is split up by the line it was called from,
+#!   using the <C>line_stacks</C> option of <Ref Func="ReadLineByLineProfile"/>.
+#!   <P/>
+#!   The option 'weight' chooses what the width of each function shows. It can
+#!   be "ticks" (the default, the time spent in the function), "calls" (the
+#!   number of times it was called, counting the calls made by the functions
+#!   it called) or "ticks_per_call" (the average time of each call, counting
+#!   the functions it called). A function can be called more often than the
+#!   function which calls it, so in a graph of ticks per call a function is
+#!   made wider when the functions it calls would not otherwise fit inside
+#!   it. Coverage profiles record no time, so a graph of calls is the only
+#!   way to see where they spend their work.
+#!   <P/>
+#!   The graph is drawn by the profiling package itself, and can be zoomed by
+#!   clicking on a function, and searched by clicking on 'Search'.
 DeclareGlobalFunction("OutputFlameGraph");
 
-#! @Arguments profile [, filename]
+#! @Arguments profile [, filename] [, options]
 #! @Description
 #!   Generate the input required to draw a 'flame graph', a method of visualising
 #!   where time is spent by a program. One program for drawing flame graphs using
@@ -67,10 +323,75 @@ DeclareGlobalFunction("OutputFlameGraph");
 #!   or a string giving the filename of a profile.
 #!   <P/>
 #!   The flame graph input will be written to <A>filename</A> (or returned as a
-#!   string if <A>filename</A> is not present).
+#!   string if <A>filename</A> is not present). If <A>filename</A> ends in
+#!   <C>.gz</C>, it will be compressed with gzip.
+#!   <P/>
+#!   The final (optional) argument is a record of options. The options 'lines'
+#!   and 'weight' are as for <Ref Func="OutputFlameGraph"/>.
 #!   <P/>
 DeclareGlobalFunction("OutputFlameGraphInput");
 
+#! @Arguments profile, dir [, options]
+#! @Description
+#!   Generate an interactive flame graph of <A>profile</A> in the directory
+#!   <A>dir</A>, which can be viewed by opening <C>index.html</C> in that
+#!   directory in a web browser. The profile is given as in
+#!   <Ref Func="OutputFlameGraph"/>.
+#!   <P/>
+#!   Unlike <Ref Func="OutputFlameGraph"/>, this can show very large
+#!   profiles. The graph is drawn on a canvas, and only the frames which are
+#!   large enough to see are drawn. The profile is split into many small
+#!   files, and the parts of it deep in the call tree are only loaded when
+#!   you zoom into them. The directory does not need anything else to be
+#!   viewed, so it can be copied or archived.
+#!   <P/>
+#!   <A>options</A> is a record, which accepts the options 'squash', 'type',
+#!   'lines', 'weight' and 'title' of <Ref Func="OutputFlameGraph"/>, and 'chunk_nodes', the
+#!   largest number of functions in each file (default 10000).
+#!   <P/>
+#!   <Ref Func="OutputAnnotatedCodeCoverageFiles"/> writes one of these
+#!   graphs in the directory <C>flame-canvas</C> of its output.
+DeclareGlobalFunction("OutputFlameGraphHTML");
+
+#! @Arguments profile, filename
+#! @Description
+#!   Write <A>profile</A> to <A>filename</A> in the Callgrind format, which
+#!   can be read by tools such as KCachegrind.
+#!   <P/>
+#!   <A>profile</A> should be either a profile previously read by
+#!   <Ref Func="ReadLineByLineProfile"/>,
+#!   or a string giving the filename of a profile.
+#!   <P/>
+#!   Each line of code is given two costs: the ticks spent executing it
+#!   (<C>Ticks</C>) and the number of times it was executed (<C>Execs</C>).
+#!   Each function call made by a line records how often that call was made,
+#!   and the ticks it took, including any functions it called. Call counts
+#!   are not available for profiles made by
+#!   <Ref Func="MergeLineByLineProfiles"/>, so calls are not included for these.
+DeclareGlobalFunction("OutputCallgrindProfile");
+
+#! @Arguments profile, filename
+#! @Description
+#!   Write <A>profile</A> to <A>filename</A> in the gzip-compressed
+#!   <C>profile.proto</C> format used by pprof
+#!   (<URL>https://github.com/google/pprof</URL>).
+#!   <P/>
+#!   <A>profile</A> should be either a profile previously read by
+#!   <Ref Func="ReadLineByLineProfile"/>,
+#!   or a string giving the filename of a profile.
+#!   <P/>
+#!   Each sample gives the number of ticks spent in a stack of functions,
+#!   and the line which was running in each of them: the line being executed
+#!   in the innermost function, and the line which made the call in every
+#!   other function. This needs the component <C>line_samples</C>, which is
+#!   only there if the profile was read with the option <C>line_stacks</C>
+#!   of <Ref Func="ReadLineByLineProfile"/> (which is done if <A>profile</A>
+#!   is a filename). For other profiles each entry of <C>stack_runtimes</C>
+#!   becomes one sample, and every function is placed at its first line.
+#!   The <C>time_type</C> of the profile (wall or CPU time) is recorded as
+#!   the period type of the profile. This requires the <C>gzip</C> program.
+DeclareGlobalFunction("OutputPprofProfile");
+
 
 #! @Section Generating coverage reports
 
@@ -90,8 +411,27 @@ DeclareGlobalFunction("OutputFlameGraphInput");
 #!   The optional second argument gives a filter, only information about filenames
 #!   starting with <A>indir</A> will be outputted.
 #!   <P/>
-#!   The final optional argument is a record of configuration options. The only
-#!   currently allowed option is 'title', which will set the title of created pages.
+#!   The final optional argument is a record of configuration options. The
+#!   option 'title' sets the title of created pages. The page for each file is
+#!   written by the kernel, and several pages are written at once; the option
+#!   'threads' sets how many (by default, one for each processor).
+#!   <P/>
+#!   The file <F>coverage-manifest.txt</F> in <A>outdir</A> records a hash of
+#!   each source file and of its part of the profile. When a report is
+#!   written again into the same directory, only the pages for files whose
+#!   source or profile changed are written again; the overview page and flame
+#!   graphs are always rewritten. Set the option 'incremental' to <K>false</K>
+#!   to write every page.
+#!   <P/>
+#!   Pages for very long files can be slow to view and sort. If the option
+#!   'virtual' is <K>true</K>, the lines of each file and their statistics
+#!   are instead written to a script next to the page, and the page only
+#!   draws the rows which can be seen, sorting on the data rather than the
+#!   table.
+#!   <P/>
+#!   The overview page links to flame graphs of the profile. If the profile
+#!   has no times (it was recorded with <C>CoverageLineByLine</C>), the flame
+#!   graphs show the number of calls of each function instead.
 DeclareGlobalFunction("OutputAnnotatedCodeCoverageFiles");
 
 #! @Arguments coverage, outfile
@@ -105,6 +445,8 @@ DeclareGlobalFunction("OutputAnnotatedCodeCoverageFiles");
 #!   be read with <F>ReadLineByLineProfile</F>.
 #!   <P/>
 #!   The output will be written to the file with name <A>outfile</A> (a string).
+#!   If <A>outfile</A> ends in <C>.gz</C>, it will be compressed with gzip.
+#!   Only files which exist are included.
 #!   <P/>
 DeclareGlobalFunction("OutputJsonCoverage");
 
@@ -118,6 +460,8 @@ DeclareGlobalFunction("OutputJsonCoverage");
 #!   be read with <F>ReadLineByLineProfile</F>.
 #!   <P/>
 #!   The output will be written to the file with name <A>outfile</A> (a string).
+#!   If <A>outfile</A> ends in <C>.gz</C>, it will be compressed with gzip.
+#!   Only files which exist are included.
 #!   <P/>
 DeclareGlobalFunction("OutputLcovCoverage");
 
@@ -139,6 +483,8 @@ DeclareGlobalFunction("OutputLcovCoverage");
 #!   (currently only supported for Travis and AppVeyor).
 #!   <P/>
 #!   The output will be written to the file with name <A>outfile</A> (a string).
+#!   If <A>outfile</A> ends in <C>.gz</C>, it will be compressed with gzip.
+#!   Only files which exist are included.
 #!   <P/>
 DeclareGlobalFunction("OutputCoverallsJsonCoverage");
 
@@ -170,9 +516,15 @@ DeclareGlobalFunction("LineByLineProfileFunction");
 #!     * <C>showOutput</C>: a boolean denoting whether to print test output to
 #!       the screen (default <K>true</K>);
 #!     * <C>open</C>: a boolean denoting whether to open the report in a web
-#!       browser on completion (default <K>false</K>).
+#!       browser on completion (default <K>false</K>);
+#!     * <C>budgets</C>: a list of performance budgets, as in
+#!       <Ref Func="AssertProfileBudget"/>. The file is then run with a time
+#!       profile rather than a coverage profile.
 #!
 #!   This function returns the location of an HTML file containing the report.
+#!   If <C>budgets</C> is given, it instead returns a record with components
+#!   <C>page</C>, the location of the report, and <C>violations</C>, as
+#!   returned by <Ref Func="AssertProfileBudget"/>.
 DeclareGlobalFunction("ProfileFile");
 
 #! @Arguments pkg_name[, opts]
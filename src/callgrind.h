@@ -0,0 +1,244 @@
+//  Please refer to the COPYRIGHT file of the profiling package for details.
+//  SPDX-License-Identifier: MIT
+/*
+ * Output profiles in the Callgrind format, which can be read by KCachegrind.
+ * The format is described at https://valgrind.org/docs/manual/cl-format.html
+ *
+ * This file is included into profiling.cc, after FullFunction is defined.
+ */
+
+#ifndef PROFILING_CALLGRIND_H
+#define PROFILING_CALLGRIND_H
+
+// Callgrind lets us give each file and function name a number the first
+// time it is used, and then just use the number.
+struct CallgrindNames
+{
+  std::map<std::string, Int> ids;
+
+  void write(FILE* out, const char* key, const std::string& name)
+  {
+    std::map<std::string, Int>::iterator it = ids.find(name);
+    if(it != ids.end())
+    {
+      fprintf(out, "%s=(%ld)\n", key, (long)it->second);
+      return;
+    }
+    Int id = ids.size() + 1;
+    ids.insert(std::make_pair(name, id));
+    fprintf(out, "%s=(%ld) %s\n", key, (long)id, name.c_str());
+  }
+};
+
+// Functions in GAP often share a name (for example, all the methods of an
+// operation), so we add the line the function starts on.
+static std::string callgrindFunctionName(const FullFunction& f)
+{
+  std::ostringstream oss;
+  oss << f.name << ":" << f.line;
+  return oss.str();
+}
+
+static Int callgrindListInt(Obj list, Int pos)
+{
+  if(!IS_SMALL_LIST(list) || LEN_LIST(list) < pos || !ELM0_LIST(list, pos))
+    throw GAPException("Invalid profile");
+  return GAP_get<Int>(ELM_LIST(list, pos));
+}
+
+// The functions in one file, ordered so an enclosing function comes before
+// the functions defined inside it.
+struct CallgrindFunctionOrder
+{
+  bool operator()(const FullFunction& lhs, const FullFunction& rhs) const
+  {
+    if(lhs.line != rhs.line)
+      return lhs.line < rhs.line;
+    if(lhs.endline != rhs.endline)
+      return lhs.endline > rhs.endline;
+    return lhs < rhs;
+  }
+};
+
+// Map each line of a file to the innermost function containing it, or
+// NULL for lines outside of any function.
+static std::vector<const FullFunction*>
+callgrindLineOwners(const std::vector<FullFunction>& funcs, Int max_line)
+{
+  std::vector<const FullFunction*> owners(max_line + 1, (const FullFunction*)NULL);
+  std::vector<const FullFunction*> open;
+  size_t next = 0;
+  for(Int line = 1; line <= max_line; ++line)
+  {
+    while(next < funcs.size() && funcs[next].line <= line)
+    {
+      open.push_back(&funcs[next]);
+      next++;
+    }
+    while(!open.empty() && open.back()->endline < line)
+      open.pop_back();
+    if(!open.empty())
+      owners[line] = open.back();
+  }
+  return owners;
+}
+
+// Write 'profile', a profile returned by READ_PROFILE_FROM_STREAM, to 'out'.
+// Each line is charged its own ticks and executions, and each call made
+// from a line is charged the ticks of that call (including children).
+static void writeCallgrind(FILE* out, Obj profile)
+{
+  GAPRecord r(profile);
+  Obj line_info = r.get("line_info");
+  Obj line_calls = r.get("line_function_calls");
+  if(!IS_SMALL_LIST(line_info) || !IS_SMALL_LIST(line_calls))
+    throw GAPException("Invalid profile");
+
+  // Merged profiles do not know how often each call was made
+  Obj call_stats = 0;
+  if(r.has("line_function_call_stats"))
+    call_stats = r.get("line_function_call_stats");
+
+  std::string time_type = "Wall";
+  if(r.has("info"))
+  {
+    GAPRecord info(r.get("info"));
+    if(info.has("time_type") && IS_STRING(info.get("time_type")))
+      time_type = GAP_get<std::string>(info.get("time_type"));
+  }
+
+  // Find every function we know about, sorted by the file it is in.
+  // We need these to decide which function each line belongs to.
+  std::map<std::string, std::set<FullFunction, CallgrindFunctionOrder> > file_functions;
+  if(r.has("functions"))
+  {
+    std::vector<FullFunction> funcs = GAP_get<std::vector<FullFunction> >(r.get("functions"));
+    for(size_t i = 0; i < funcs.size(); ++i)
+      file_functions[funcs[i].filename].insert(funcs[i]);
+  }
+
+  std::map<std::string, Obj> calls_by_file;
+  std::map<std::string, Obj> stats_by_file;
+  for(Int i = 1; i <= LEN_LIST(line_calls); ++i)
+  {
+    Obj entry = ELM0_LIST(line_calls, i);
+    if(!entry || !IS_SMALL_LIST(entry) || LEN_LIST(entry) != 2)
+      throw GAPException("Invalid profile");
+    std::string filename = GAP_get<std::string>(ELM_LIST(entry, 1));
+    Obj lines = ELM_LIST(entry, 2);
+    calls_by_file[filename] = lines;
+    for(Int j = 1; j <= LEN_LIST(lines); ++j)
+    {
+      Obj called = ELM0_LIST(lines, j);
+      if(!called)
+        continue;
+      std::vector<FullFunction> funcs = GAP_get<std::vector<FullFunction> >(called);
+      for(size_t k = 0; k < funcs.size(); ++k)
+        file_functions[funcs[k].filename].insert(funcs[k]);
+    }
+    if(call_stats && IS_SMALL_LIST(call_stats) && LEN_LIST(call_stats) >= i)
+    {
+      Obj stats_entry = ELM0_LIST(call_stats, i);
+      if(stats_entry && IS_SMALL_LIST(stats_entry) && LEN_LIST(stats_entry) == 2)
+        stats_by_file[filename] = ELM_LIST(stats_entry, 2);
+    }
+  }
+
+  CallgrindNames files;
+  CallgrindNames functions;
+
+  fprintf(out, "# callgrind format\n");
+  fprintf(out, "version: 1\n");
+  fprintf(out, "creator: GAP profiling package\n");
+  fprintf(out, "positions: line\n");
+  fprintf(out, "event: Ticks : %s time (ticks)\n", time_type.c_str());
+  fprintf(out, "event: Execs : Executions\n");
+  fprintf(out, "events: Ticks Execs\n");
+
+  Int total_ticks = 0;
+  Int total_execs = 0;
+
+  for(Int i = 1; i <= LEN_LIST(line_info); ++i)
+  {
+    Obj entry = ELM0_LIST(line_info, i);
+    if(!entry || !IS_SMALL_LIST(entry) || LEN_LIST(entry) != 2)
+      throw GAPException("Invalid profile");
+    std::string filename = GAP_get<std::string>(ELM_LIST(entry, 1));
+    Obj lines = ELM_LIST(entry, 2);
+    if(!IS_SMALL_LIST(lines))
+      throw GAPException("Invalid profile");
+
+    const std::set<FullFunction, CallgrindFunctionOrder>& funcset = file_functions[filename];
+    std::vector<FullFunction> funcs(funcset.begin(), funcset.end());
+    Int max_line = LEN_LIST(lines);
+    std::vector<const FullFunction*> owners = callgrindLineOwners(funcs, max_line);
+
+    Obj calls = calls_by_file.count(filename) ? calls_by_file[filename] : 0;
+    Obj stats = stats_by_file.count(filename) ? stats_by_file[filename] : 0;
+
+    fprintf(out, "\n");
+    files.write(out, "fl", filename);
+    // Force a 'fn=' before the first cost line of every file
+    const FullFunction* current = NULL;
+    bool first = true;
+
+    for(Int line = 1; line <= max_line; ++line)
+    {
+      Obj info = ELM0_LIST(lines, line);
+      Int execs = 0;
+      Int ticks = 0;
+      if(info)
+      {
+        execs = callgrindListInt(info, 2);
+        ticks = callgrindListInt(info, 3);
+      }
+
+      Obj called = 0;
+      if(calls && LEN_LIST(calls) >= line)
+        called = ELM0_LIST(calls, line);
+      Obj called_stats = 0;
+      if(stats && IS_SMALL_LIST(stats) && LEN_LIST(stats) >= line)
+        called_stats = ELM0_LIST(stats, line);
+      bool has_calls = called && IS_SMALL_LIST(called) && LEN_LIST(called) > 0 && called_stats;
+
+      if(execs == 0 && ticks == 0 && !has_calls)
+        continue;
+
+      if(first || owners[line] != current)
+      {
+        first = false;
+        current = owners[line];
+        if(current)
+          functions.write(out, "fn", callgrindFunctionName(*current));
+        else
+          functions.write(out, "fn", "[top level]:" + filename);
+      }
+
+      if(execs != 0 || ticks != 0)
+      {
+        fprintf(out, "%ld %ld %ld\n", (long)line, (long)ticks, (long)execs);
+        total_ticks += ticks;
+        total_execs += execs;
+      }
+
+      if(has_calls)
+      {
+        for(Int j = 1; j <= LEN_LIST(called); ++j)
+        {
+          FullFunction callee = GAP_get<FullFunction>(ELM_LIST(called, j));
+          if(!IS_SMALL_LIST(called_stats) || LEN_LIST(called_stats) < j)
+            throw GAPException("Invalid profile");
+          Obj callee_stats = ELM_LIST(called_stats, j);
+          files.write(out, "cfl", callee.filename);
+          functions.write(out, "cfn", callgrindFunctionName(callee));
+          fprintf(out, "calls=%ld %ld\n", (long)callgrindListInt(callee_stats, 1), (long)callee.line);
+          fprintf(out, "%ld %ld\n", (long)line, (long)callgrindListInt(callee_stats, 2));
+        }
+      }
+    }
+  }
+
+  fprintf(out, "\ntotals: %ld %ld\n", (long)total_ticks, (long)total_execs);
+}
+
+#endif
@@ -0,0 +1,130 @@
+//  Please refer to the COPYRIGHT file of the profiling package for details.
+//  SPDX-License-Identifier: MIT
+/*
+ * Output the sequence of function calls in a profile in the Chrome
+ * Trace Event Format, which can be viewed in Perfetto or chrome://tracing.
+ * The format is described at
+ * https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+ *
+ * This file is included into profiling.cc, after FullFunction is defined.
+ */
+
+#ifndef PROFILING_CHROME_TRACE_H
+#define PROFILING_CHROME_TRACE_H
+
+// Write 's' as a JSON string
+static void writeJsonString(FILE* out, const std::string& s)
+{
+  putc('"', out);
+  for(size_t i = 0; i < s.size(); ++i)
+  {
+    unsigned char c = s[i];
+    switch(c)
+    {
+      case '"': fputs("\\\"", out); break;
+      case '\\': fputs("\\\\", out); break;
+      case '\n': fputs("\\n", out); break;
+      case '\r': fputs("\\r", out); break;
+      case '\t': fputs("\\t", out); break;
+      default:
+        if(c < 0x20)
+          fprintf(out, "\\u%04x", c);
+        else
+          putc(c, out);
+    }
+  }
+  putc('"', out);
+}
+
+// Writes a 'B' event when a function starts and an 'E' event when it ends.
+// Calls which take less than 'min_ticks' are left out (their time is
+// shown as part of their caller), so traces of large computations stay
+// small enough to view.
+//
+// We do not know how long a call will take when it starts, so a 'B'
+// event is only written once a call has been running for 'min_ticks'.
+// If a call is written then so are all of its callers, so the calls
+// which have been written are always the bottom of the stack.
+struct ChromeTrace
+{
+  struct Frame
+  {
+    FullFunction function;
+    Int start;
+    Frame(const FullFunction& f, Int s) : function(f), start(s) { }
+  };
+
+  FILE* out;
+  Int min_ticks;
+  std::vector<Frame> frames;
+  // How many of 'frames' have had their 'B' event written
+  size_t written;
+  Int events;
+
+  ChromeTrace(FILE* _out, Int _min_ticks)
+    : out(_out), min_ticks(_min_ticks), written(0), events(0)
+  {
+    if(out)
+      fputs("{\"traceEvents\":[\n", out);
+  }
+
+  void writeEvent(char type, const FullFunction& f, Int ts)
+  {
+    if(events > 0)
+      fputs(",\n", out);
+    events++;
+    fputs("{\"name\":", out);
+    writeJsonString(out, f.name);
+    fprintf(out, ",\"cat\":\"gap\",\"ph\":\"%c\",\"ts\":%ld,\"pid\":1,\"tid\":1", type, (long)ts);
+    if(type == 'B')
+    {
+      fputs(",\"args\":{\"file\":", out);
+      writeJsonString(out, f.filename);
+      fprintf(out, ",\"line\":%ld}", (long)f.line);
+    }
+    putc('}', out);
+  }
+
+  void enter(const FullFunction& f, Int now)
+  {
+    if(out)
+      frames.push_back(Frame(f, now));
+  }
+
+  // Time has moved on to 'now', so write any calls which are now long enough
+  void advance(Int now)
+  {
+    if(!out)
+      return;
+    while(written < frames.size() && now - frames[written].start >= min_ticks)
+    {
+      writeEvent('B', frames[written].function, frames[written].start);
+      written++;
+    }
+  }
+
+  void leave(Int now)
+  {
+    if(!out || frames.empty())
+      return;
+    advance(now);
+    if(written == frames.size())
+    {
+      writeEvent('E', frames.back().function, now);
+      written--;
+    }
+    frames.pop_back();
+  }
+
+  // End all calls which are still running, and the trace
+  void finish(Int now)
+  {
+    if(!out)
+      return;
+    while(!frames.empty())
+      leave(now);
+    fputs("\n],\"displayTimeUnit\":\"ms\"}\n", out);
+  }
+};
+
+#endif
@@ -0,0 +1,227 @@
+//  Please refer to the COPYRIGHT file of the profiling package for details.
+//  SPDX-License-Identifier: MIT
+/*
+ * Write the coverage of a profile for other tools: lcov tracefiles
+ * (OutputLcovCoverage), codecov's JSON format (OutputJsonCoverage) and
+ * coveralls' JSON format (OutputCoverallsJsonCoverage). The line stats are
+ * copied out of GAP, and each file is then written in one pass through a
+ * large buffer. Files whose name ends in .gz are compressed with gzip.
+ *
+ * Only source files which exist are included, as these tools look for the
+ * files in the repository. Files are looked up in the source cache
+ * (source_cache.h), so the coveralls export opens each file once, to check
+ * it and find its digest.
+ *
+ * This file is included into profiling.cc, after coverage_html.h.
+ */
+
+#ifndef PROFILING_COVERAGE_EXPORT_H
+#define PROFILING_COVERAGE_EXPORT_H
+
+// The coverage of one source file
+struct CoverageFile
+{
+  std::string filename;
+  std::vector<CoverageLine> lines;
+};
+
+// Read the files in 'line_info' (as in a profile from
+// ReadLineByLineProfile) which exist. The caller must hold a
+// SourceCacheGuard.
+static std::vector<CoverageFile> readCoverageFiles(Obj line_info)
+{
+  if(!IS_SMALL_LIST(line_info))
+    throw GAPException("line_info must be a list");
+  std::vector<CoverageFile> files;
+  for(Int i = 1; i <= LEN_LIST(line_info); ++i)
+  {
+    Obj file = ELM_LIST(line_info, i);
+    if(!IS_SMALL_LIST(file) || LEN_LIST(file) < 2)
+      throw GAPException("Invalid entry in line_info");
+    std::string filename = GAP_get<std::string>(ELM_LIST(file, 1));
+    if(!sourceCache.get(filename)->present())
+      continue;
+    files.push_back(CoverageFile());
+    files.back().filename = filename;
+    files.back().lines = readCoverageLines(ELM_LIST(file, 2));
+  }
+  return files;
+}
+
+// Writes a coverage file, building it in a buffer which is written out in
+// large blocks
+struct CoverageExportWriter
+{
+  std::string filename;
+  OutStream out;
+  std::string buf;
+
+  CoverageExportWriter(const std::string& _filename)
+    : filename(_filename), out(_filename.c_str(), endsWithgz(_filename.c_str()))
+  {
+    if(out.fail())
+      throw GAPException("Unable to open file " + filename);
+  }
+
+  void flush(bool force)
+  {
+    if(!force && buf.size() < (1 << 20))
+      return;
+    if(fwrite(buf.data(), 1, buf.size(), out.stream) != buf.size())
+      throw GAPException("Unable to write file " + filename);
+    buf.clear();
+  }
+
+  void close()
+  {
+    flush(true);
+    if(!out.close())
+      throw GAPException("Unable to write file " + filename);
+  }
+};
+
+// An lcov tracefile, with the number of times each line which was read or
+// executed ran
+static Obj writeLcovCoverage(Obj line_info, Obj filename)
+{
+  SourceCacheGuard guard;
+  std::vector<CoverageFile> files = readCoverageFiles(line_info);
+  CoverageExportWriter writer(GAP_get<std::string>(filename));
+  for(size_t f = 0; f < files.size(); ++f)
+  {
+    writer.buf += "TN:\nSF:";
+    writer.buf += files[f].filename;
+    writer.buf += '\n';
+    const std::vector<CoverageLine>& lines = files[f].lines;
+    for(size_t i = 0; i < lines.size(); ++i)
+    {
+      if(lines[i].read > 0 || lines[i].exec > 0)
+      {
+        writer.buf += "DA:";
+        appendInt(writer.buf, i + 1);
+        writer.buf += ',';
+        appendInt(writer.buf, lines[i].exec);
+        writer.buf += '\n';
+      }
+    }
+    writer.buf += "end_of_record\n";
+    writer.flush(false);
+  }
+  writer.close();
+  return True;
+}
+
+// codecov's JSON format, which marks each line which was read as "1" if
+// it was executed and "0" if not
+static Obj writeJsonCoverage(Obj line_info, Obj filename)
+{
+  SourceCacheGuard guard;
+  std::vector<CoverageFile> files = readCoverageFiles(line_info);
+  CoverageExportWriter writer(GAP_get<std::string>(filename));
+  writer.buf += "{ \"coverage\": {\n";
+  for(size_t f = 0; f < files.size(); ++f)
+  {
+    if(f > 0)
+      writer.buf += ",\n";
+    appendJsonString(writer.buf, files[f].filename.data(), files[f].filename.size());
+    writer.buf += ": {\n";
+    const std::vector<CoverageLine>& lines = files[f].lines;
+    bool first = true;
+    for(size_t i = 0; i < lines.size(); ++i)
+    {
+      if(lines[i].read > 0)
+      {
+        if(!first)
+          writer.buf += ",\n";
+        first = false;
+        writer.buf += '"';
+        appendInt(writer.buf, i + 1);
+        writer.buf += lines[i].exec > 0 ? "\": \"1\"" : "\": \"0\"";
+      }
+    }
+    writer.buf += "}\n";
+    writer.flush(false);
+  }
+  writer.buf += "} }";
+  writer.close();
+  return True;
+}
+
+// Remove every copy of 'path' from 'filename', as ReplacedString does
+static std::string removePath(const std::string& filename, const std::string& path)
+{
+  if(path.empty())
+    return filename;
+  std::string ret;
+  size_t start = 0;
+  size_t found;
+  while((found = filename.find(path, start)) != std::string::npos)
+  {
+    ret.append(filename, start, found - start);
+    start = found + path.size();
+  }
+  ret.append(filename, start, std::string::npos);
+  return ret;
+}
+
+// coveralls' JSON format. 'options.metadata' is a list of pairs
+// [key, value] of strings to put at the start, describing the CI job, and
+// 'options.pathtoremove' is removed from each filename. Each line which
+// was read has the number of times it was executed, and other lines are
+// null.
+static Obj writeCoverallsCoverage(Obj line_info, Obj filename, Obj options)
+{
+  SourceCacheGuard guard;
+  if(!IS_REC(options))
+    throw GAPException("Coveralls options must be a record");
+  GAPRecord r(options);
+  std::string pathtoremove = GAP_get<std::string>(r.get("pathtoremove"));
+  std::vector<std::pair<std::string, std::string> > metadata =
+    GAP_get<std::vector<std::pair<std::string, std::string> > >(r.get("metadata"));
+
+  std::vector<CoverageFile> files = readCoverageFiles(line_info);
+  std::vector<std::string> names;
+  for(size_t f = 0; f < files.size(); ++f)
+    names.push_back(files[f].filename);
+  MD5Queue digests(names);
+  digests.run(names.size(), 0);
+
+  CoverageExportWriter writer(GAP_get<std::string>(filename));
+  writer.buf += "{\n";
+  for(size_t i = 0; i < metadata.size(); ++i)
+  {
+    appendJsonString(writer.buf, metadata[i].first.data(), metadata[i].first.size());
+    writer.buf += ": ";
+    appendJsonString(writer.buf, metadata[i].second.data(), metadata[i].second.size());
+    writer.buf += ",\n";
+  }
+  writer.buf += "\"source_files\": [\n";
+  for(size_t f = 0; f < files.size(); ++f)
+  {
+    if(f > 0)
+      writer.buf += ",\n";
+    std::string name = removePath(files[f].filename, pathtoremove);
+    writer.buf += "{\n\"name\": ";
+    appendJsonString(writer.buf, name.data(), name.size());
+    writer.buf += ",\n\"source_digest\": \"";
+    writer.buf += digests.digests[f];
+    writer.buf += "\",\n\"coverage\": [";
+    const std::vector<CoverageLine>& lines = files[f].lines;
+    for(size_t i = 0; i < lines.size(); ++i)
+    {
+      if(i > 0)
+        writer.buf += ", ";
+      if(lines[i].read > 0)
+        appendInt(writer.buf, lines[i].exec);
+      else
+        writer.buf += "null";
+    }
+    writer.buf += "]\n}\n";
+    writer.flush(false);
+  }
+  writer.buf += "] }";
+  writer.close();
+  return True;
+}
+
+#endif
@@ -0,0 +1,865 @@
+//  Please refer to the COPYRIGHT file of the profiling package for details.
+//  SPDX-License-Identifier: MIT
+/*
+ * Write the pages for each source file of the HTML coverage report made by
+ * OutputAnnotatedCodeCoverageFiles, which show how often each line was
+ * executed, how long it took, and which functions it called. The data for
+ * every page is copied out of GAP first, and then the pages are written
+ * in parallel.
+ *
+ * A manifest in the output directory records a hash of the inputs of each
+ * page, so pages whose source and data have not changed since the last
+ * report are not written again.
+ *
+ * In the virtual mode, each page is instead a small HTML file and a script
+ * holding the lines and their statistics, which data/coveragepage.js draws
+ * a screenful at a time, so very long files stay quick to view and sort.
+ *
+ * This file is included into profiling.cc, after source_cache.h.
+ */
+
+#ifndef PROFILING_COVERAGE_HTML_H
+#define PROFILING_COVERAGE_HTML_H
+
+#include <unistd.h>
+#include <stdint.h>
+#include <string.h>
+
+// Append 'n' to 'out', with a comma between each group of three digits
+static void appendWithSeparators(std::string& out, Int n)
+{
+  char digits[32];
+  int len = snprintf(digits, sizeof(digits), "%ld", (long)n);
+  int start = (digits[0] == '-') ? 1 : 0;
+  out.append(digits, start);
+  for(int i = start; i < len; ++i)
+  {
+    if(i > start && (len - i) % 3 == 0)
+      out += ',';
+    out += digits[i];
+  }
+}
+
+static void appendInt(std::string& out, Int n)
+{
+  char digits[32];
+  snprintf(digits, sizeof(digits), "%ld", (long)n);
+  out += digits;
+}
+
+// The entry at 'pos' of 'list', or 0 if it has none. The lists in a
+// profile which are indexed by line have holes for lines with no data.
+static Obj coverageEntry(Obj list, Int pos)
+{
+  if(!list || !IS_SMALL_LIST(list) || pos > LEN_LIST(list))
+    return 0;
+  return ELM0_LIST(list, pos);
+}
+
+// One entry [read, exec, time, child_time] of the 'line_info' of a file
+struct CoverageLine
+{
+  bool bound;
+  Int read;
+  Int exec;
+  Int time;
+  Int child_time;
+
+  CoverageLine() : bound(false), read(0), exec(0), time(0), child_time(0)
+  { }
+
+  bool ignored() const
+  { return !bound || (read == 0 && exec == 0 && time == 0 && child_time == 0); }
+};
+
+static std::vector<CoverageLine> readCoverageLines(Obj list)
+{
+  if(!IS_SMALL_LIST(list))
+    throw GAPException("line_info must be a list");
+  std::vector<CoverageLine> lines(LEN_LIST(list));
+  for(size_t i = 0; i < lines.size(); ++i)
+  {
+    Obj entry = ELM0_LIST(list, i + 1);
+    if(!entry)
+      continue;
+    if(!IS_SMALL_LIST(entry) || LEN_LIST(entry) < 4)
+      throw GAPException("Invalid entry in line_info");
+    lines[i].bound = true;
+    lines[i].read = GAP_get<Int>(ELM_LIST(entry, 1));
+    lines[i].exec = GAP_get<Int>(ELM_LIST(entry, 2));
+    lines[i].time = GAP_get<Int>(ELM_LIST(entry, 3));
+    lines[i].child_time = GAP_get<Int>(ELM_LIST(entry, 4));
+  }
+  return lines;
+}
+
+// What the overview page of the report needs to know about each file
+struct CoverageSummary
+{
+  Int exec_lines;
+  // Lines which were read but never executed. This is only known if no
+  // line was executed without being read, which happens when a file was
+  // read before profiling started.
+  bool has_coverage;
+  Int read_not_exec_lines;
+  bool has_timing;
+  Int exec_count;
+  Int time;
+
+  CoverageSummary() : exec_lines(0), has_coverage(true), read_not_exec_lines(0),
+                      has_timing(false), exec_count(0), time(0)
+  { }
+};
+
+namespace GAPdetail {
+template<>
+struct GAP_maker<CoverageSummary>
+{
+  Obj operator()(const CoverageSummary& s)
+  {
+    GAPRecord r;
+    r.set("exec_lines", s.exec_lines);
+    r.set("has_coverage", s.has_coverage);
+    if(s.has_coverage)
+      r.set("read_not_exec_lines", s.read_not_exec_lines);
+    r.set("has_timing", s.has_timing);
+    if(s.has_timing)
+    {
+      r.set("exec_count", s.exec_count);
+      r.set("time", s.time);
+    }
+    return r.raw_obj();
+  }
+};
+}
+
+static CoverageSummary summariseCoverage(const std::vector<CoverageLine>& lines)
+{
+  CoverageSummary s;
+  for(size_t i = 0; i < lines.size(); ++i)
+  {
+    const CoverageLine& l = lines[i];
+    if(!l.bound)
+      continue;
+    if(l.exec >= 1)
+      s.exec_lines++;
+    if(l.read == 0 && l.exec > 0)
+      s.has_coverage = false;
+    if(l.read >= 1 && l.exec == 0)
+      s.read_not_exec_lines++;
+    if(l.time > 0)
+      s.has_timing = true;
+    s.exec_count += l.exec;
+    s.time += l.time;
+  }
+  return s;
+}
+
+// The settings shared by every page of a report
+struct CoveragePageOptions
+{
+  bool has_title;
+  std::string title;
+  bool is_cover;
+  std::string css;
+  std::string css_timing;
+  std::string css_no_timing;
+  // How many pages to write at once, or 0 for one per processor
+  Int threads;
+  // The file recording the inputs of each page, or "" for none
+  std::string manifest;
+  // If false, every page is written, even if the manifest shows it is up
+  // to date
+  bool incremental;
+  // Write pages for data/coveragepage.js, rather than as full tables
+  bool virtual_rows;
+};
+
+static CoveragePageOptions readCoveragePageOptions(Obj o)
+{
+  if(!IS_REC(o))
+    throw GAPException("Coverage page options must be a record");
+  GAPRecord r(o);
+  CoveragePageOptions opts;
+  opts.has_title = r.has("title");
+  if(opts.has_title)
+    opts.title = GAP_get<std::string>(r.get("title"));
+  opts.is_cover = GAP_get<bool>(r.get("is_cover"));
+  opts.css = GAP_get<std::string>(r.get("css"));
+  opts.css_timing = GAP_get<std::string>(r.get("css_timing"));
+  opts.css_no_timing = GAP_get<std::string>(r.get("css_no_timing"));
+  opts.threads = 0;
+  if(r.has("threads"))
+    opts.threads = GAP_get<Int>(r.get("threads"));
+  if(r.has("manifest"))
+    opts.manifest = GAP_get<std::string>(r.get("manifest"));
+  opts.incremental = true;
+  if(r.has("incremental"))
+    opts.incremental = GAP_get<bool>(r.get("incremental"));
+  opts.virtual_rows = false;
+  if(r.has("virtual"))
+    opts.virtual_rows = GAP_get<bool>(r.get("virtual"));
+  return opts;
+}
+
+// A link from one page of the report to a line of another, with the number
+// of calls and ticks it stands for (if known)
+struct CoverageLink
+{
+  std::string filename;
+  Int line;
+  // The text of the link
+  std::string text;
+  bool has_stats;
+  Int calls;
+  Int ticks;
+
+  CoverageLink() : line(0), has_stats(false), calls(0), ticks(0)
+  { }
+};
+
+// Everything needed to write the page for one file, copied out of GAP so
+// pages can be written on other threads
+struct CoveragePage
+{
+  std::string outname;
+  std::string source;
+  std::vector<CoverageLine> coverage;
+  // The functions called from each line, and the functions each line
+  // (the start of a function) was called from
+  std::vector<std::vector<CoverageLink> > called;
+  std::vector<std::vector<CoverageLink> > callers;
+
+  CoverageSummary summary;
+  // Hashes of the source file, and of everything else shown on the page
+  uint64_t source_hash;
+  uint64_t data_hash;
+  // False if the page was already up to date
+  bool written;
+
+  CoveragePage() : source_hash(0), data_hash(0), written(false)
+  { }
+
+  // The name of the page within the report, used in the manifest
+  std::string basename() const
+  {
+    std::string::size_type slash = outname.rfind('/');
+    return slash == std::string::npos ? outname : outname.substr(slash + 1);
+  }
+};
+
+// The hashes of each page in the last report, by the name of the page
+typedef std::map<std::string, std::pair<uint64_t, uint64_t> > CoverageManifest;
+
+// Change this whenever the pages are written differently, so pages from
+// older reports are written again
+static const Int coveragePageVersion = 1;
+
+static void hashCoverageLinks(FastHash& hash, const std::vector<std::vector<CoverageLink> >& links)
+{
+  hash.add((Int)links.size());
+  for(size_t i = 0; i < links.size(); ++i)
+  {
+    hash.add((Int)links[i].size());
+    for(size_t j = 0; j < links[i].size(); ++j)
+    {
+      const CoverageLink& l = links[i][j];
+      hash.add(l.filename);
+      hash.add(l.line);
+      hash.add(l.text);
+      hash.add((Int)l.has_stats);
+      hash.add(l.calls);
+      hash.add(l.ticks);
+    }
+  }
+}
+
+// A hash of everything shown on 'page', apart from its source
+static uint64_t hashCoveragePage(const CoveragePage& page, const CoveragePageOptions& opts)
+{
+  FastHash hash;
+  hash.add(coveragePageVersion);
+  hash.add((Int)opts.has_title);
+  hash.add(opts.title);
+  hash.add((Int)opts.is_cover);
+  hash.add(opts.css);
+  hash.add(opts.css_timing);
+  hash.add(opts.css_no_timing);
+  hash.add((Int)opts.virtual_rows);
+  hash.add((Int)page.coverage.size());
+  for(size_t i = 0; i < page.coverage.size(); ++i)
+  {
+    const CoverageLine& l = page.coverage[i];
+    hash.add((Int)l.bound);
+    hash.add(l.read);
+    hash.add(l.exec);
+    hash.add(l.time);
+    hash.add(l.child_time);
+  }
+  hashCoverageLinks(hash, page.called);
+  hashCoverageLinks(hash, page.callers);
+  return hash.value();
+}
+
+// Each line of a manifest is "source_hash data_hash name", with the
+// hashes in hex. A missing or damaged manifest just means every page is
+// written.
+static CoverageManifest readCoverageManifest(const std::string& filename)
+{
+  CoverageManifest manifest;
+  FILE* in = fopen(filename.c_str(), "r");
+  if(!in)
+    return manifest;
+  char line[4096];
+  while(fgets(line, sizeof(line), in))
+  {
+    unsigned long long source, data;
+    int name_start;
+    if(sscanf(line, "%llx %llx %n", &source, &data, &name_start) != 2)
+      continue;
+    std::string name(line + name_start);
+    if(!name.empty() && name[name.size() - 1] == '\n')
+      name.erase(name.size() - 1);
+    manifest[name] = std::make_pair((uint64_t)source, (uint64_t)data);
+  }
+  fclose(in);
+  return manifest;
+}
+
+static void writeCoverageManifest(const std::string& filename,
+                                  const std::vector<CoveragePage>& pages)
+{
+  // Write a new file and move it into place, so an interrupted report
+  // does not leave a damaged manifest
+  std::string tmp = filename + ".tmp";
+  FILE* out = fopen(tmp.c_str(), "w");
+  if(!out)
+    throw GAPException("Unable to open file " + tmp);
+  for(size_t i = 0; i < pages.size(); ++i)
+  {
+    fprintf(out, "%016llx %016llx %s\n", (unsigned long long)pages[i].source_hash,
+            (unsigned long long)pages[i].data_hash, pages[i].basename().c_str());
+  }
+  if(fclose(out) != 0 || rename(tmp.c_str(), filename.c_str()) != 0)
+    throw GAPException("Unable to write file " + filename);
+}
+
+// Read a function (or location) 'fn'. If 'with_name' is false, or the
+// function has no name, the link is shown as "filename:line".
+static CoverageLink readCoverageLink(Obj fn, bool with_name)
+{
+  if(!IS_REC(fn))
+    throw GAPException("Invalid function in coverage data");
+  GAPRecord r(fn);
+  CoverageLink link;
+  link.filename = GAP_get<std::string>(r.get("filename"));
+  link.line = GAP_get<Int>(r.get("line"));
+  if(with_name)
+    link.text = GAP_get<std::string>(r.get("name"));
+  if(!with_name || link.text == "nameless")
+  {
+    std::ostringstream text;
+    text << link.filename << ":" << link.line;
+    link.text = text.str();
+  }
+  return link;
+}
+
+// Read the links for each line from 'list'. If 'stats' is given, it is a
+// list of pairs [calls, ticks] matching each link.
+static void readCoverageLinks(Obj list, Obj stats, bool with_name,
+                              std::vector<std::vector<CoverageLink> >& links)
+{
+  if(!IS_SMALL_LIST(list))
+    throw GAPException("Invalid list of functions in coverage data");
+  links.resize(LEN_LIST(list));
+  for(size_t i = 0; i < links.size(); ++i)
+  {
+    Obj fns = coverageEntry(list, i + 1);
+    if(!fns || !IS_SMALL_LIST(fns))
+      continue;
+    Obj line_stats = coverageEntry(stats, i + 1);
+    for(Int j = 1; j <= LEN_LIST(fns); ++j)
+    {
+      CoverageLink link = readCoverageLink(ELM_LIST(fns, j), with_name);
+      Obj stat = coverageEntry(line_stats, j);
+      if(stat && IS_SMALL_LIST(stat) && LEN_LIST(stat) >= 2)
+      {
+        link.has_stats = true;
+        link.calls = GAP_get<Int>(ELM_LIST(stat, 1));
+        link.ticks = GAP_get<Int>(ELM_LIST(stat, 2));
+      }
+      links[i].push_back(link);
+    }
+  }
+}
+
+// 'page' is a record giving the 'outname' of the page, the 'source'
+// filename, and the parts of the profile for it: 'line_info',
+// 'function_calls', 'function_call_stats' (which merged profiles do not
+// have) and 'calling_functions'.
+static CoveragePage readCoveragePage(Obj page)
+{
+  if(!IS_REC(page))
+    throw GAPException("Coverage page data must be a record");
+  GAPRecord r(page);
+  CoveragePage p;
+  p.outname = GAP_get<std::string>(r.get("outname"));
+  p.source = GAP_get<std::string>(r.get("source"));
+  p.coverage = readCoverageLines(r.get("line_info"));
+  readCoverageLinks(r.get("function_calls"),
+                    r.has("function_call_stats") ? r.get("function_call_stats") : 0,
+                    true, p.called);
+  readCoverageLinks(r.get("calling_functions"), 0, false, p.callers);
+  return p;
+}
+
+// The class of the row for each line
+static const char* const coverageLineClasses[] = { "ignore", "exec", "missed" };
+
+// The index of the class of the row for 'l' in coverageLineClasses
+static int coverageLineClass(const CoverageLine& l)
+{
+  if(l.ignored())
+    return 0;
+  if(l.exec >= 1)
+    return 1;
+  if(l.read >= 1)
+    return 2;
+  throw GAPException("Invalid profile - there were lines which were not executed, but took time!");
+}
+
+// The numbers shown in the Execs, Time and Time+Childs columns for 'l',
+// or -1 where the column is blank
+static void coverageLineColumns(const CoverageLine& l, bool is_cover,
+                                Int& execs, Int& time, Int& total)
+{
+  execs = time = total = -1;
+  if(!l.bound || l.exec < 1)
+    return;
+  execs = l.exec;
+  if(is_cover && execs > 1)
+    execs = 0;
+  if(l.time >= 1 || l.child_time >= 1)
+  {
+    time = l.time;
+    total = l.child_time + l.time;
+  }
+}
+
+// Append 's' to 'out' as a JSON string
+static void appendJsonString(std::string& out, const char* s, size_t len)
+{
+  out += '"';
+  for(size_t i = 0; i < len; ++i)
+  {
+    unsigned char c = s[i];
+    switch(c)
+    {
+      case '"': out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n"; break;
+      case '\r': out += "\\r"; break;
+      case '\t': out += "\\t"; break;
+      default:
+        if(c < 0x20)
+        {
+          char esc[8];
+          snprintf(esc, sizeof(esc), "\\u%04x", c);
+          out += esc;
+        }
+        else
+          out += c;
+    }
+  }
+  out += '"';
+}
+
+// Writes a page, building it in a buffer which is written out in large
+// blocks. This does not use GAP, so can run on any thread.
+struct CoveragePageWriter
+{
+  FILE* out;
+  std::string buf;
+
+  CoveragePageWriter(FILE* _out) : out(_out)
+  { }
+
+  void flush(bool force)
+  {
+    if(!force && buf.size() < (1 << 20))
+      return;
+    if(fwrite(buf.data(), 1, buf.size(), out) != buf.size())
+      throw GAPException("Unable to write coverage page");
+    buf.clear();
+  }
+
+  void link(const CoverageLink& l)
+  {
+    buf += "<a href=\"";
+    for(size_t i = 0; i < l.filename.size(); ++i)
+      buf += (l.filename[i] == '/') ? '_' : l.filename[i];
+    buf += ".html#line";
+    appendInt(buf, l.line);
+    buf += "\">";
+    buf += l.text;
+    buf += "</a> ";
+    // How often, and for how long, this line called the function
+    if(l.has_stats)
+    {
+      buf += '(';
+      appendWithSeparators(buf, l.calls);
+      buf += "&times;, ";
+      appendWithSeparators(buf, l.ticks);
+      buf += ") ";
+    }
+  }
+
+  void links(const std::vector<std::vector<CoverageLink> >& all, Int i)
+  {
+    if(i > (Int)all.size())
+      return;
+    const std::vector<CoverageLink>& line = all[i - 1];
+    for(size_t j = 0; j < line.size(); ++j)
+      link(line[j]);
+  }
+
+  void head(const CoveragePageOptions& opts)
+  {
+    buf += "<!DOCTYPE html><script src=\"sorttable.js\"></script><html>\n<head><title>\n";
+    if(opts.has_title)
+      buf += opts.title;
+    buf += "</title></head>\n";
+  }
+
+  // The row for line 'i', which contains 'text'
+  void row(Int i, const char* text, size_t len, const CoverageLine& l, bool timing,
+           const CoveragePage& page, const CoveragePageOptions& opts)
+  {
+    buf += "<tr class='";
+    buf += coverageLineClasses[coverageLineClass(l)];
+    buf += "'><td><a name=\"line";
+    appendInt(buf, i);
+    buf += "\"></a>";
+    appendInt(buf, i);
+    buf += "</td>";
+
+    if(timing)
+    {
+      Int execs, time, total;
+      coverageLineColumns(l, opts.is_cover, execs, time, total);
+      if(execs >= 0)
+      {
+        buf += "<td>";
+        appendWithSeparators(buf, execs);
+        buf += "</td><td>";
+        if(time >= 0)
+        {
+          appendWithSeparators(buf, time);
+          buf += "</td><td>";
+          appendWithSeparators(buf, total);
+        }
+        else
+          buf += "</td><td>";
+        buf += "</td>";
+      }
+      else
+        buf += "<td></td><td></td><td></td>";
+    }
+
+    buf += "<td><span><tt>";
+    appendHtmlEncoded(buf, text, len);
+    buf += "</tt></span></td>";
+
+    if(timing)
+    {
+      buf += "<td><span>";
+      links(page.called, i);
+      buf += "</span></td><td><span>";
+      links(page.callers, i);
+      buf += "</span></td>";
+    }
+    buf += "</tr>\n";
+    flush(false);
+  }
+};
+
+// Files which do not exist are shown as a line of "<missing file>" for
+// each line in the profile
+static const char missingSourceLine[] = "<missing file>";
+
+// The number of lines to show on the page for 'source'
+static size_t coveragePageLines(const CoveragePage& page, SourceFile* source)
+{
+  return source->exists() ? source->lineCount() : page.coverage.size();
+}
+
+// Line 'i' of 'source' (which coveragePageLines must have been called on)
+static const char* coveragePageLine(SourceFile* source, size_t i, size_t& len)
+{
+  if(source->exists())
+    return source->line(i, len);
+  len = sizeof(missingSourceLine) - 1;
+  return missingSourceLine;
+}
+
+// The script holding the data for a page in the virtual mode
+static std::string coverageDataName(const CoveragePage& page)
+{
+  return page.outname + ".js";
+}
+
+// Write the full table for 'page'
+static void writeCoverageTable(const CoveragePage& page, SourceFile* source,
+                               const CoveragePageOptions& opts)
+{
+  bool timing = page.summary.has_timing;
+
+  OutStream out(page.outname.c_str(), false);
+  if(out.fail())
+    throw GAPException("Unable to open file " + page.outname);
+  CoveragePageWriter writer(out.stream);
+  writer.head(opts);
+  writer.buf += "<body>\n<style>";
+  writer.buf += opts.css;
+  writer.buf += timing ? opts.css_timing : opts.css_no_timing;
+  writer.buf += "</style>";
+  if(!page.summary.has_coverage)
+    writer.buf += "<p>This file was read by GAP before profiling was actived, so lines "
+                  "which were not read but not executed are not marked.</p>";
+  writer.buf += "<table class=\"sortable\">\n<thead><tr>";
+  if(timing)
+    writer.buf += "<th>Line</th><th>Execs</th><th>Time</th><th>Time+Childs</th><th>Code</th>"
+                  "<th>Called Functions</th><th>Called From</th>\n";
+  else
+    writer.buf += "<th>Line</th><th>Code</th>\n";
+  writer.buf += "</tr></thead>\n<tbody>\n";
+
+  size_t count = coveragePageLines(page, source);
+  CoverageLine none;
+  for(size_t i = 1; i <= count; ++i)
+  {
+    size_t len;
+    const char* text = coveragePageLine(source, i, len);
+    writer.row(i, text, len, i <= page.coverage.size() ? page.coverage[i - 1] : none,
+               timing, page, opts);
+  }
+  writer.buf += "</tbody>\n</table></body></html>\n";
+  writer.flush(true);
+  if(!out.close())
+    throw GAPException("Unable to write file " + page.outname);
+}
+
+// Append the links for each line of 'all' as an object from line numbers
+// to the HTML for their links, leaving out lines with none
+static void appendCoverageLinks(std::string& out, const std::vector<std::vector<CoverageLink> >& all)
+{
+  CoveragePageWriter html(0);
+  bool first = true;
+  out += '{';
+  for(size_t i = 1; i <= all.size(); ++i)
+  {
+    if(all[i - 1].empty())
+      continue;
+    html.buf.clear();
+    html.links(all, i);
+    if(!first)
+      out += ',';
+    first = false;
+    out += '"';
+    appendInt(out, i);
+    out += "\":";
+    appendJsonString(out, html.buf.data(), html.buf.size());
+  }
+  out += '}';
+}
+
+// Write 'page' for the virtual mode. The HTML page only loads
+// coveragepage.js and the data for the page, a call
+//   coveragePage({"timing": bool, "lines": [text, ...], "kinds": string,
+//                 "execs": [...], "times": [...], "totals": [...],
+//                 "called": {line: html, ...}, "callers": {line: html, ...}})
+// where the characters of 'kinds' are the index of the class of each line
+// in coverageLineClasses, and the other lists (only given with 'timing')
+// hold the columns of each line as in coverageLineColumns.
+static void writeVirtualCoveragePage(const CoveragePage& page, SourceFile* source,
+                                     const CoveragePageOptions& opts)
+{
+  bool timing = page.summary.has_timing;
+  std::string dataname = coverageDataName(page);
+  std::string::size_type slash = dataname.rfind('/');
+  std::string datafile = (slash == std::string::npos) ? dataname : dataname.substr(slash + 1);
+
+  {
+    OutStream out(page.outname.c_str(), false);
+    if(out.fail())
+      throw GAPException("Unable to open file " + page.outname);
+    CoveragePageWriter writer(out.stream);
+    writer.buf += "<!DOCTYPE html><html>\n<head><title>\n";
+    if(opts.has_title)
+      writer.buf += opts.title;
+    writer.buf += "</title>\n<style>";
+    writer.buf += opts.css;
+    writer.buf += timing ? opts.css_timing : opts.css_no_timing;
+    writer.buf += "</style></head>\n<body class=\"virtual\">\n";
+    if(!page.summary.has_coverage)
+      writer.buf += "<p>This file was read by GAP before profiling was actived, so lines "
+                    "which were not read but not executed are not marked.</p>";
+    writer.buf += "<div id=\"coverage\"></div>\n"
+                  "<script src=\"coveragepage.js\"></script>\n<script src=\"";
+    appendHtmlEncoded(writer.buf, datafile.data(), datafile.size());
+    writer.buf += "\"></script>\n</body></html>\n";
+    writer.flush(true);
+    if(!out.close())
+      throw GAPException("Unable to write file " + page.outname);
+  }
+
+  OutStream out(dataname.c_str(), false);
+  if(out.fail())
+    throw GAPException("Unable to open file " + dataname);
+  CoveragePageWriter writer(out.stream);
+  size_t count = coveragePageLines(page, source);
+  CoverageLine none;
+  writer.buf += "coveragePage({\"timing\":";
+  writer.buf += timing ? "true" : "false";
+  writer.buf += ",\n\"lines\":[";
+  for(size_t i = 1; i <= count; ++i)
+  {
+    size_t len;
+    const char* text = coveragePageLine(source, i, len);
+    // Each row shows one line, so leave out the newline
+    if(len > 0 && text[len - 1] == '\n')
+      len--;
+    if(i > 1)
+      writer.buf += ",\n";
+    appendJsonString(writer.buf, text, len);
+    writer.flush(false);
+  }
+  writer.buf += "],\n\"kinds\":\"";
+  for(size_t i = 1; i <= count; ++i)
+  {
+    const CoverageLine& l = i <= page.coverage.size() ? page.coverage[i - 1] : none;
+    writer.buf += (char)('0' + coverageLineClass(l));
+  }
+  writer.buf += '"';
+  if(timing)
+  {
+    std::string columns[3];
+    for(size_t i = 1; i <= count; ++i)
+    {
+      const CoverageLine& l = i <= page.coverage.size() ? page.coverage[i - 1] : none;
+      Int values[3];
+      coverageLineColumns(l, opts.is_cover, values[0], values[1], values[2]);
+      for(int c = 0; c < 3; ++c)
+      {
+        if(i > 1)
+          columns[c] += ',';
+        appendInt(columns[c], values[c]);
+      }
+    }
+    const char* names[3] = { "execs", "times", "totals" };
+    for(int c = 0; c < 3; ++c)
+    {
+      writer.buf += ",\n\"";
+      writer.buf += names[c];
+      writer.buf += "\":[";
+      writer.buf += columns[c];
+      writer.buf += ']';
+      writer.flush(false);
+    }
+    writer.buf += ",\n\"called\":";
+    appendCoverageLinks(writer.buf, page.called);
+    writer.buf += ",\n\"callers\":";
+    appendCoverageLinks(writer.buf, page.callers);
+  }
+  writer.buf += "});\n";
+  writer.flush(true);
+  if(!out.close())
+    throw GAPException("Unable to write file " + dataname);
+}
+
+// Are the files for 'page' still there from the last report?
+static bool coveragePageExists(const CoveragePage& page, const CoveragePageOptions& opts)
+{
+  if(access(page.outname.c_str(), F_OK) != 0)
+    return false;
+  return !opts.virtual_rows || access(coverageDataName(page).c_str(), F_OK) == 0;
+}
+
+// Write the page for 'page', unless 'previous' shows it is up to date, and
+// fill in its summary
+static void writeCoveragePage(CoveragePage& page, const CoveragePageOptions& opts,
+                              const CoverageManifest& previous)
+{
+  page.summary = summariseCoverage(page.coverage);
+
+  SourceFile* source = sourceCache.get(page.source);
+  page.source_hash = source->fastHash();
+  page.data_hash = hashCoveragePage(page, opts);
+
+  CoverageManifest::const_iterator old = previous.find(page.basename());
+  if(old != previous.end() && old->second.first == page.source_hash &&
+     old->second.second == page.data_hash && coveragePageExists(page, opts))
+    return;
+  page.written = true;
+
+  if(opts.virtual_rows)
+    writeVirtualCoveragePage(page, source, opts);
+  else
+    writeCoverageTable(page, source, opts);
+}
+
+// Writes each page on its own thread
+struct CoveragePageQueue : public WorkQueue
+{
+  std::vector<CoveragePage>& pages;
+  const CoveragePageOptions& opts;
+  const CoverageManifest& previous;
+
+  CoveragePageQueue(std::vector<CoveragePage>& _pages, const CoveragePageOptions& _opts,
+                    const CoverageManifest& _previous)
+    : pages(_pages), opts(_opts), previous(_previous)
+  { }
+
+  void job(size_t index)
+  { writeCoveragePage(pages[index], opts, previous); }
+};
+
+// Write every page in the list 'pages' (see readCoveragePage), using
+// 'options.threads' threads (by default, one for each processor). If
+// 'options.manifest' is given, pages it shows are up to date are skipped
+// (unless 'options.incremental' is false), and it is then updated. If
+// 'options.virtual' is true, pages are written for data/coveragepage.js.
+// Returns the summary of each page, for the overview page of the report.
+static Obj writeCoveragePages(Obj pagelist, Obj options)
+{
+  SourceCacheGuard guard;
+  CoveragePageOptions opts = readCoveragePageOptions(options);
+  if(!IS_SMALL_LIST(pagelist))
+    throw GAPException("Coverage pages must be given as a list");
+  std::vector<CoveragePage> pages;
+  for(Int i = 1; i <= LEN_LIST(pagelist); ++i)
+    pages.push_back(readCoveragePage(ELM_LIST(pagelist, i)));
+
+  CoverageManifest previous;
+  if(!opts.manifest.empty() && opts.incremental)
+    previous = readCoverageManifest(opts.manifest);
+
+  CoveragePageQueue queue(pages, opts, previous);
+  queue.run(pages.size(), opts.threads);
+
+  Obj ret = NEW_PLIST(T_PLIST, pages.size());
+  SET_LEN_PLIST(ret, pages.size());
+  for(size_t i = 0; i < pages.size(); ++i)
+  {
+    GAPRecord r(GAP_make(pages[i].summary));
+    r.set("written", pages[i].written);
+    SET_ELM_PLIST(ret, i + 1, r.raw_obj());
+    CHANGED_BAG(ret);
+  }
+  if(!opts.manifest.empty())
+    writeCoverageManifest(opts.manifest, pages);
+  return ret;
+}
+
+#endif
@@ -0,0 +1,1059 @@
+//  Please refer to the COPYRIGHT file of the profiling package for details.
+//  SPDX-License-Identifier: MIT
+/*
+ * Draw flame graphs as interactive SVG files, in the style of
+ * https://github.com/brendangregg/FlameGraph (clicking a frame zooms into
+ * it, and frames can be searched for by regular expression). Differential
+ * flame graphs, comparing two profiles, are drawn as flamegraph.pl draws
+ * the output of difffolded.pl.
+ *
+ * This file is included into profiling.cc, after StackTrace and
+ * FunctionTable are defined.
+ */
+
+#ifndef PROFILING_FLAMEGRAPH_H
+#define PROFILING_FLAMEGRAPH_H
+
+#include <math.h>
+#include <errno.h>
+#include <deque>
+
+// Layout of the graph, in pixels. These match flamegraph.pl.
+static const double flameImageWidth = 1200;
+static const double flameFrameHeight = 16;
+static const double flameFontSize = 12;
+static const double flameFontWidth = 0.59;
+static const double flameXPad = 10;
+static const double flameYPadTop = flameFontSize * 3;
+static const double flameYPadBottom = flameFontSize * 2 + 10;
+
+// What the width of each frame shows. Coverage profiles have no ticks, so
+// for them only the number of calls is useful.
+enum FlameWeight
+{
+  FlameTicks,
+  FlameCalls,
+  FlameTicksPerCall
+};
+
+struct FlameGraphOptions
+{
+  bool reverse;
+  bool squash;
+  // Frames narrower than this many pixels are left out, along with
+  // everything they call, to keep the size of the graph bounded.
+  double minwidth;
+  std::string title;
+  FlameWeight weight;
+
+  FlameGraphOptions() : reverse(false), squash(false), minwidth(0.1), title("Flame Graph"),
+                        weight(FlameTicks)
+  { }
+
+  // Which of the four trees built by readFlameGraphTrees to draw
+  int tree() const
+  { return (reverse ? 2 : 0) + (squash ? 1 : 0); }
+
+  // The unit of the width of a frame, shown when hovering over it
+  const char* unit() const
+  {
+    switch(weight)
+    {
+      case FlameCalls: return "calls";
+      case FlameTicksPerCall: return "ticks per call";
+      default: return "ticks";
+    }
+  }
+};
+
+// Finds the weight of each node of a call tree on its own, not counting
+// the functions it calls, so the weight of a subtree is the sum of the
+// weights of its nodes.
+//
+// When weighing by ticks per call, each function is as wide as the average
+// time of one of its calls, including the functions it called. Functions
+// may be called more often than the functions which call them, so a
+// function is made wider when the functions it calls would not fit in it.
+struct FlameWeigher
+{
+  FlameWeight weight;
+  // For FlameTicksPerCall, the weight of each subtree
+  std::map<const StackTrace*, Int> subtrees;
+
+  FlameWeigher(const StackTrace* root, FlameWeight _weight) : weight(_weight)
+  {
+    if(weight == FlameTicksPerCall)
+      weighPerCall(root);
+  }
+
+  // Returns the ticks spent in 'st' and the functions it called
+  Int weighPerCall(const StackTrace* st)
+  {
+    Int ticks = st->runtime;
+    Int children = 0;
+    if(st->children)
+    {
+      for(std::map<Int, StackTrace>::const_iterator it = st->children->begin();
+          it != st->children->end(); ++it)
+      {
+        ticks += weighPerCall(&(it->second));
+        children += subtrees[&(it->second)];
+      }
+    }
+    // Time spent outside any function (at the root) has no calls
+    if(st->calls == 0)
+      subtrees[st] = st->runtime + children;
+    else
+      subtrees[st] = std::max((ticks + st->calls / 2) / st->calls, children);
+    return ticks;
+  }
+
+  Int node(const StackTrace* st) const
+  {
+    switch(weight)
+    {
+      case FlameCalls:
+        return st->calls;
+      case FlameTicksPerCall:
+      {
+        Int w = subtrees.find(st)->second;
+        if(st->children)
+        {
+          for(std::map<Int, StackTrace>::const_iterator it = st->children->begin();
+              it != st->children->end(); ++it)
+            w -= subtrees.find(&(it->second))->second;
+        }
+        return w;
+      }
+      default:
+        return st->runtime;
+    }
+  }
+};
+
+// Stores the weight of every subtree of 'st', and the number of nodes in
+// the subtree, in the order the nodes are visited, like weighStackTrace.
+static Int weighFlameTree(const StackTrace* st, const FlameWeigher& weigher,
+                          std::vector<Int>& weights, std::vector<Int>& sizes)
+{
+  size_t index = weights.size();
+  weights.push_back(0);
+  sizes.push_back(0);
+  Int w = weigher.node(st);
+  if(st->children)
+  {
+    for(std::map<Int, StackTrace>::const_iterator it = st->children->begin();
+        it != st->children->end(); ++it)
+      w += weighFlameTree(&(it->second), weigher, weights, sizes);
+  }
+  weights[index] = w;
+  sizes[index] = weights.size() - index;
+  return w;
+}
+
+static double GAP_get_number(Obj o)
+{
+  if(IS_INTOBJ(o))
+    return INT_INTOBJ(o);
+  if(IS_MACFLOAT(o))
+    return VAL_MACFLOAT(o);
+  throw GAPException("Expected a small integer or float");
+}
+
+static FlameGraphOptions readFlameGraphOptions(Obj o)
+{
+  if(!IS_REC(o))
+    throw GAPException("Flame graph options must be a record");
+  GAPRecord r(o);
+  FlameGraphOptions opts;
+  if(r.has("reverse"))
+    opts.reverse = GAP_get<bool>(r.get("reverse"));
+  if(r.has("squash"))
+    opts.squash = GAP_get<bool>(r.get("squash"));
+  if(r.has("minwidth"))
+    opts.minwidth = GAP_get_number(r.get("minwidth"));
+  if(r.has("title"))
+    opts.title = GAP_get<std::string>(r.get("title"));
+  if(r.has("weight"))
+  {
+    std::string weight = GAP_get<std::string>(r.get("weight"));
+    if(weight == "ticks")
+      opts.weight = FlameTicks;
+    else if(weight == "calls")
+      opts.weight = FlameCalls;
+    else if(weight == "ticks_per_call")
+      opts.weight = FlameTicksPerCall;
+    else
+      throw GAPException("Flame graph weight must be 'ticks', 'calls' or 'ticks_per_call'");
+  }
+  return opts;
+}
+
+// Read 'stack_runtimes' once, building the call tree of each of the four
+// kinds of flame graph (normal or reversed, and with or without recursive
+// calls squashed) which 'wanted' asks for.
+static void readFlameGraphTrees(Obj stack_runtimes, FunctionTable& functions,
+                                StackTrace* trees, const bool* wanted)
+{
+  if(!IS_SMALL_LIST(stack_runtimes))
+    throw GAPException("stack_runtimes must be a list");
+  for(int k = 0; k < 4; ++k)
+    trees[k].setupChildren();
+
+  std::vector<Int> path;
+  Int len = LEN_LIST(stack_runtimes);
+  for(Int i = 1; i <= len; ++i)
+  {
+    Obj entry = ELM0_LIST(stack_runtimes, i);
+    if(!entry || !IS_SMALL_LIST(entry) || LEN_LIST(entry) < 2)
+      throw GAPException("Invalid entry in stack_runtimes");
+    Obj pathobj = ELM_LIST(entry, 1);
+    if(!IS_SMALL_LIST(pathobj))
+      throw GAPException("Invalid entry in stack_runtimes");
+    Int ticks = GAP_get<Int>(ELM_LIST(entry, 2));
+    Int calls = LEN_LIST(entry) >= 3 ? GAP_get<Int>(ELM_LIST(entry, 3)) : 0;
+
+    path.clear();
+    Int depth = LEN_LIST(pathobj);
+    for(Int j = 1; j <= depth; ++j)
+      path.push_back(functions.intern(GAP_get<FullFunction>(ELM_LIST(pathobj, j))));
+
+    for(int k = 0; k < 4; ++k)
+    {
+      if(!wanted[k])
+        continue;
+      bool reverse = k >= 2;
+      bool squash = k % 2 == 1;
+      StackTrace* st = &trees[k];
+      Int prev = -1;
+      for(size_t j = 0; j < path.size(); ++j)
+      {
+        Int id = reverse ? path[path.size() - 1 - j] : path[j];
+        if(squash && id == prev)
+          continue;
+        prev = id;
+        st = &(st->children->insert(std::make_pair(id, StackTrace(st))).first->second);
+        st->setupChildren();
+      }
+      st->runtime += ticks;
+      st->calls += calls;
+    }
+  }
+}
+
+static void appendXmlEscaped(std::string& out, const std::string& s)
+{
+  for(size_t i = 0; i < s.size(); ++i)
+  {
+    unsigned char c = s[i];
+    switch(c)
+    {
+      case '&': out += "&amp;"; break;
+      case '<': out += "&lt;"; break;
+      case '>': out += "&gt;"; break;
+      case '"': out += "&quot;"; break;
+      default:
+        // Control characters are not allowed in XML
+        if(c >= 0x20 || c == '\t' || c == '\n')
+          out += (char)c;
+    }
+  }
+}
+
+static std::string flameFunctionName(const FullFunction& f)
+{
+  std::ostringstream oss;
+  oss << f.name << "@" << f.filename << ":" << f.line;
+  return oss.str();
+}
+
+// The part of 'name' which fits in a frame 'width' pixels wide. The
+// script in the SVG does the same when zooming.
+static std::string flameFrameLabel(const std::string& name, double width)
+{
+  Int chars = (Int)floor((width - 3) / (flameFontSize * flameFontWidth));
+  if(chars < 3)
+    return "";
+  if((Int)name.size() <= chars)
+    return name;
+  size_t end = chars - 2;
+  // Do not split a UTF-8 character
+  while(end > 0 && (name[end] & 0xC0) == 0x80)
+    end--;
+  return name.substr(0, end) + "..";
+}
+
+// A warm colour, which depends only on 'name', so the same function has
+// the same colour in every graph.
+static std::string flameFrameColour(const std::string& name)
+{
+  UInt hash = 2166136261u;
+  for(size_t i = 0; i < name.size(); ++i)
+  {
+    hash ^= (unsigned char)name[i];
+    hash = (hash * 16777619u) & 0xFFFFFFFFu;
+  }
+  double v1 = (hash & 0xFF) / 255.0;
+  double v2 = ((hash >> 8) & 0xFF) / 255.0;
+  double v3 = ((hash >> 16) & 0xFF) / 255.0;
+  char buf[64];
+  snprintf(buf, sizeof(buf), "rgb(%d,%d,%d)",
+           (int)(205 + 50 * v3), (int)(230 * v1), (int)(55 * v2));
+  return buf;
+}
+
+// The colour of a frame of a differential flame graph, as flamegraph.pl
+// chooses it: white if the ticks of the frame itself did not change, and
+// otherwise red if they grew or blue if they shrank, more strongly the
+// closer 'delta' is to the largest change, 'maxdelta'.
+static std::string flameDiffColour(Int delta, Int maxdelta)
+{
+  int r = 255, g = 255, b = 255;
+  if(delta > 0)
+    g = b = (int)(210.0 * (maxdelta - delta) / maxdelta);
+  else if(delta < 0)
+    r = g = (int)(210.0 * (maxdelta + delta) / maxdelta);
+  char buf[64];
+  snprintf(buf, sizeof(buf), "rgb(%d,%d,%d)", r, g, b);
+  return buf;
+}
+
+// The script which makes the graph interactive. Each frame is a <g> in
+// #frames, containing a <title> ("name (weight unit, percent)"), a <rect> and a
+// <text>. The original position of a frame is kept in 'ox' and 'owidth'
+// attributes while zoomed.
+static const char* flameGraphScript =
+"var fontsize = 12, fontwidth = 0.59, xpad = 10;\n"
+"var frames, details, searchbtn, unzoombtn, matchedtxt, width, searching = null;\n"
+"function init(evt) {\n"
+"  frames = document.getElementById(\"frames\");\n"
+"  details = document.getElementById(\"details\").firstChild;\n"
+"  searchbtn = document.getElementById(\"search\");\n"
+"  unzoombtn = document.getElementById(\"unzoom\");\n"
+"  matchedtxt = document.getElementById(\"matched\").firstChild;\n"
+"  width = parseFloat(document.documentElement.getAttribute(\"width\")) - 2 * xpad;\n"
+"  frames.addEventListener(\"click\", function(e) { var g = find_group(e.target); if (g) zoom(g); });\n"
+"  frames.addEventListener(\"mouseover\", function(e) { var g = find_group(e.target); if (g) details.nodeValue = title_of(g); });\n"
+"  frames.addEventListener(\"mouseout\", function(e) { details.nodeValue = \" \"; });\n"
+"  searchbtn.addEventListener(\"click\", search_prompt);\n"
+"  unzoombtn.addEventListener(\"click\", unzoom);\n"
+"  window.addEventListener(\"keydown\", function(e) {\n"
+"    if (e.keyCode === 114 || ((e.ctrlKey || e.metaKey) && e.keyCode === 70)) { e.preventDefault(); search_prompt(); }\n"
+"    else if (e.keyCode === 27) { reset_search(); unzoom(); }\n"
+"  });\n"
+"}\n"
+"function find_group(node) {\n"
+"  while (node && node.parentNode !== frames) node = node.parentNode;\n"
+"  return node;\n"
+"}\n"
+"function title_of(g) { return g.getElementsByTagName(\"title\")[0].textContent; }\n"
+"function name_of(g) { return title_of(g).replace(/ \\([^(]*\\)$/, \"\"); }\n"
+"function rect_of(g) { return g.getElementsByTagName(\"rect\")[0]; }\n"
+"function orig(g, attr) {\n"
+"  var r = rect_of(g), v = r.getAttribute(\"o\" + attr);\n"
+"  if (v === null) { v = r.getAttribute(attr); r.setAttribute(\"o\" + attr, v); }\n"
+"  return parseFloat(v);\n"
+"}\n"
+"function place(g, x, w) {\n"
+"  var r = rect_of(g), t = g.getElementsByTagName(\"text\")[0], name = name_of(g);\n"
+"  var chars = Math.floor((w - 3) / (fontsize * fontwidth));\n"
+"  r.setAttribute(\"x\", x.toFixed(2));\n"
+"  r.setAttribute(\"width\", w.toFixed(2));\n"
+"  t.setAttribute(\"x\", (x + 3).toFixed(2));\n"
+"  t.textContent = chars < 3 ? \"\" : (name.length <= chars ? name : name.substring(0, chars - 2) + \"..\");\n"
+"}\n"
+"function zoom(g) {\n"
+"  var x0 = orig(g, \"x\"), w0 = orig(g, \"width\"), y0 = orig(g, \"y\"), ratio = width / w0, all = frames.children;\n"
+"  unzoombtn.classList.remove(\"hide\");\n"
+"  for (var i = 0; i < all.length; i++) {\n"
+"    var e = all[i], x = orig(e, \"x\"), w = orig(e, \"width\"), y = orig(e, \"y\");\n"
+"    if (y > y0 && x <= x0 + 0.01 && x + w >= x0 + w0 - 0.01) {\n"
+"      e.style.display = \"\"; e.style.opacity = \"0.5\"; place(e, xpad, width);\n"
+"    } else if (y <= y0 && x >= x0 - 0.01 && x + w <= x0 + w0 + 0.01) {\n"
+"      e.style.display = \"\"; e.style.opacity = \"\"; place(e, xpad + (x - x0) * ratio, w * ratio);\n"
+"    } else {\n"
+"      e.style.display = \"none\";\n"
+"    }\n"
+"  }\n"
+"}\n"
+"function unzoom() {\n"
+"  var all = frames.children;\n"
+"  unzoombtn.classList.add(\"hide\");\n"
+"  for (var i = 0; i < all.length; i++) {\n"
+"    var e = all[i];\n"
+"    e.style.display = \"\"; e.style.opacity = \"\";\n"
+"    place(e, orig(e, \"x\"), orig(e, \"width\"));\n"
+"  }\n"
+"}\n"
+"function search_prompt() {\n"
+"  if (searching !== null) { reset_search(); return; }\n"
+"  var term = prompt(\"Enter a search term (regexp allowed)\", \"\");\n"
+"  if (term) search(term);\n"
+"}\n"
+"function reset_search() {\n"
+"  var all = frames.children;\n"
+"  for (var i = 0; i < all.length; i++) {\n"
+"    var r = rect_of(all[i]), f = r.getAttribute(\"ofill\");\n"
+"    if (f !== null) r.setAttribute(\"fill\", f);\n"
+"  }\n"
+"  searching = null;\n"
+"  searchbtn.classList.remove(\"show\");\n"
+"  searchbtn.firstChild.nodeValue = \"Search\";\n"
+"  matchedtxt.nodeValue = \" \";\n"
+"}\n"
+"function search(term) {\n"
+"  var re, all = frames.children, spans = [], covered = 0, end = -1;\n"
+"  try { re = new RegExp(term); } catch (err) { alert(err.message); return; }\n"
+"  reset_search();\n"
+"  for (var i = 0; i < all.length; i++) {\n"
+"    var r = rect_of(all[i]);\n"
+"    if (!re.test(name_of(all[i]))) continue;\n"
+"    if (r.getAttribute(\"ofill\") === null) r.setAttribute(\"ofill\", r.getAttribute(\"fill\"));\n"
+"    r.setAttribute(\"fill\", \"rgb(230,0,230)\");\n"
+"    spans.push([orig(all[i], \"x\"), orig(all[i], \"width\")]);\n"
+"  }\n"
+"  searching = term;\n"
+"  searchbtn.classList.add(\"show\");\n"
+"  searchbtn.firstChild.nodeValue = \"Reset Search\";\n"
+"  // Frames inside other matching frames must not be counted twice\n"
+"  spans.sort(function(a, b) { return a[0] - b[0]; });\n"
+"  for (var j = 0; j < spans.length; j++) {\n"
+"    var s = spans[j][0], e = s + spans[j][1];\n"
+"    if (e > end) { covered += e - Math.max(s, end); end = e; }\n"
+"  }\n"
+"  matchedtxt.nodeValue = \"Matched: \" + (100 * covered / width).toFixed(1) + \"%\";\n"
+"}\n";
+
+// A child of a node of the call tree, with the position of its subtree in
+// the weights from weighFlameTree. Children are drawn sorted by name, as
+// flamegraph.pl does, so graphs do not depend on the order functions were
+// first seen in.
+struct FlameChild
+{
+  const std::string* name;
+  Int id;
+  StackTrace* st;
+  Int index;
+
+  FlameChild(const std::string* _name, Int _id, StackTrace* _st, Int _index)
+    : name(_name), id(_id), st(_st), index(_index)
+  { }
+
+  bool operator<(const FlameChild& rhs) const
+  { return *name < *rhs.name; }
+};
+
+// Draws the frames of one call tree. 'weights' and 'sizes' come from
+// weighFlameTree, and 'index' is the position of the current node in them.
+// For a differential flame graph, 'deltas' gives the change in the ticks
+// of each node itself, which is shown in its colour and title.
+struct FlameGraphWriter
+{
+  std::string& out;
+  const FunctionTable& functions;
+  const std::vector<Int>& weights;
+  const std::vector<Int>& sizes;
+  double scale;
+  double minwidth;
+  const char* unit;
+  double height;
+  Int total;
+  // The name of each function, formatted once
+  std::vector<std::string> names;
+  const std::map<const StackTrace*, Int>* deltas;
+  // The largest change of any node, which is at least 1 as in flamegraph.pl
+  Int maxdelta;
+
+  FlameGraphWriter(std::string& _out, const FunctionTable& _functions,
+                   const std::vector<Int>& _weights,
+                   const std::vector<Int>& _sizes, double _minwidth, const char* _unit,
+                   const std::map<const StackTrace*, Int>* _deltas)
+    : out(_out), functions(_functions), weights(_weights), sizes(_sizes),
+      scale(0), minwidth(_minwidth), unit(_unit), height(0), total(_weights[0]),
+      names(_functions.size()), deltas(_deltas), maxdelta(1)
+  {
+    if(total > 0)
+      scale = (flameImageWidth - 2 * flameXPad) / total;
+    if(deltas)
+    {
+      for(std::map<const StackTrace*, Int>::const_iterator it = deltas->begin();
+          it != deltas->end(); ++it)
+        maxdelta = std::max(maxdelta, it->second < 0 ? -it->second : it->second);
+    }
+  }
+
+  Int delta(const StackTrace* st) const
+  {
+    std::map<const StackTrace*, Int>::const_iterator it = deltas->find(st);
+    return it == deltas->end() ? 0 : it->second;
+  }
+
+  // The depth of the deepest frame which will be drawn
+  Int maxDepth(Int index, Int depth) const
+  {
+    Int deepest = depth;
+    Int end = index + sizes[index];
+    for(Int child = index + 1; child < end; child += sizes[child])
+    {
+      if(weights[child] * scale >= minwidth)
+        deepest = std::max(deepest, maxDepth(child, depth + 1));
+    }
+    return deepest;
+  }
+
+  void frame(const StackTrace* st, const std::string& name, Int weight, double x, Int depth)
+  {
+    char buf[256];
+    double width = weight * scale;
+    double y = height - flameYPadBottom - (depth + 1) * flameFrameHeight + 1;
+    out += "<g><title>";
+    appendXmlEscaped(out, name);
+    snprintf(buf, sizeof(buf), " (%ld %s, %.2f%%", (long)weight, unit, 100.0 * weight / total);
+    out += buf;
+    // The root has no change of its own
+    if(deltas && depth > 0)
+    {
+      Int d = delta(st);
+      snprintf(buf, sizeof(buf), "; %s%.2f%%", d > 0 ? "+" : "", 100.0 * d / total);
+      out += buf;
+    }
+    out += ")</title>";
+    snprintf(buf, sizeof(buf), "<rect x=\"%.2f\" y=\"%.1f\" width=\"%.2f\" height=\"%.1f\" fill=\"",
+             x, y, width, flameFrameHeight - 1);
+    out += buf;
+    out += deltas ? flameDiffColour(delta(st), maxdelta) : flameFrameColour(name);
+    snprintf(buf, sizeof(buf), "\" rx=\"2\" ry=\"2\"/><text x=\"%.2f\" y=\"%.1f\">", x + 3, y + 10.5);
+    out += buf;
+    appendXmlEscaped(out, flameFrameLabel(name, width));
+    out += "</text></g>\n";
+  }
+
+  const std::string& name(Int id)
+  {
+    if(names[id].empty())
+      names[id] = flameFunctionName(functions[id]);
+    return names[id];
+  }
+
+  void node(StackTrace* st, Int index, Int id, double x, Int depth)
+  {
+    Int weight = weights[index];
+    if(weight * scale < minwidth)
+      return;
+    frame(st, id < 0 ? std::string("all") : name(id), weight, x, depth);
+    if(!st->children)
+      return;
+    // The subtrees are stored in the order of the children's ids
+    std::vector<FlameChild> children;
+    Int child = index + 1;
+    for(std::map<Int, StackTrace>::iterator it = st->children->begin();
+        it != st->children->end(); ++it)
+    {
+      children.push_back(FlameChild(&name(it->first), it->first, &(it->second), child));
+      weight -= weights[child];
+      child += sizes[child];
+    }
+    std::sort(children.begin(), children.end());
+    // Time spent in this node itself comes first, as in flamegraph.pl
+    x += weight * scale;
+    for(size_t i = 0; i < children.size(); ++i)
+    {
+      node(children[i].st, children[i].index, children[i].id, x, depth + 1);
+      x += weights[children[i].index] * scale;
+    }
+  }
+};
+
+// Draw the call tree 'root' as an SVG flame graph, appending it to 'out'.
+// If 'deltas' is given, this is a differential flame graph, coloured by
+// the change in the ticks of each node.
+static void writeFlameGraph(std::string& out, StackTrace* root, const FunctionTable& functions,
+                            const FlameGraphOptions& opts,
+                            const std::map<const StackTrace*, Int>* deltas = 0)
+{
+  std::vector<Int> weights;
+  std::vector<Int> sizes;
+  weighFlameTree(root, FlameWeigher(root, opts.weight), weights, sizes);
+  FlameGraphWriter writer(out, functions, weights, sizes, opts.minwidth, opts.unit(), deltas);
+  Int depth = writer.total > 0 ? writer.maxDepth(0, 0) : 0;
+  writer.height = (depth + 1) * flameFrameHeight + flameYPadTop + flameYPadBottom;
+
+  char buf[512];
+  out += "<?xml version=\"1.0\" standalone=\"no\"?>\n"
+         "<!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.1//EN\" "
+         "\"http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd\">\n";
+  snprintf(buf, sizeof(buf),
+           "<svg version=\"1.1\" width=\"%.0f\" height=\"%.0f\" onload=\"init(evt)\" "
+           "viewBox=\"0 0 %.0f %.0f\" xmlns=\"http://www.w3.org/2000/svg\" "
+           "xmlns:xlink=\"http://www.w3.org/1999/xlink\">\n",
+           flameImageWidth, writer.height, flameImageWidth, writer.height);
+  out += buf;
+  out += "<defs><linearGradient id=\"background\" y1=\"0\" y2=\"1\" x1=\"0\" x2=\"0\">"
+         "<stop stop-color=\"#eeeeee\" offset=\"5%\"/><stop stop-color=\"#eeeeb0\" offset=\"95%\"/>"
+         "</linearGradient></defs>\n"
+         "<style type=\"text/css\">\n"
+         "text { font-family: Verdana; font-size: 12px; fill: rgb(0,0,0); }\n"
+         "#title { text-anchor: middle; font-size: 17px; }\n"
+         "#frames > g:hover { stroke: black; stroke-width: 0.5; cursor: pointer; }\n"
+         "#search, #unzoom { opacity: 0.1; cursor: pointer; }\n"
+         "#search:hover, #search.show, #unzoom:hover { opacity: 1; }\n"
+         "#unzoom.hide { display: none; }\n"
+         "</style>\n"
+         "<script type=\"text/ecmascript\"><![CDATA[\n";
+  out += flameGraphScript;
+  out += "]]></script>\n";
+  snprintf(buf, sizeof(buf),
+           "<rect x=\"0\" y=\"0\" width=\"%.0f\" height=\"%.0f\" fill=\"url(#background)\"/>\n"
+           "<text id=\"title\" x=\"%.0f\" y=\"24\">",
+           flameImageWidth, writer.height, flameImageWidth / 2);
+  out += buf;
+  appendXmlEscaped(out, opts.title);
+  snprintf(buf, sizeof(buf),
+           "</text>\n"
+           "<text id=\"details\" x=\"%.0f\" y=\"%.0f\"> </text>\n"
+           "<text id=\"unzoom\" class=\"hide\" x=\"%.0f\" y=\"24\">Reset Zoom</text>\n"
+           "<text id=\"search\" x=\"%.0f\" y=\"24\">Search</text>\n"
+           "<text id=\"matched\" x=\"%.0f\" y=\"%.0f\"> </text>\n"
+           "<g id=\"frames\">\n",
+           flameXPad, writer.height - 17, flameXPad, flameImageWidth - flameXPad - 100,
+           flameImageWidth - flameXPad - 100, writer.height - 17);
+  out += buf;
+  if(writer.total > 0)
+    writer.node(root, 0, -1, flameXPad, 0);
+  out += "</g>\n</svg>\n";
+}
+
+// Draw a flame graph of 'stack_runtimes' for each record of options in
+// 'graphs'. Graphs with a 'filename' are written to that file, and for
+// the others we return the SVG as a string.
+static Obj writeFlameGraphs(Obj stack_runtimes, Obj graphs)
+{
+  if(!IS_SMALL_LIST(graphs))
+    throw GAPException("Flame graph options must be given as a list");
+  std::vector<FlameGraphOptions> opts;
+  std::vector<std::string> filenames;
+  bool wanted[4] = { false, false, false, false };
+  for(Int i = 1; i <= LEN_LIST(graphs); ++i)
+  {
+    Obj o = ELM0_LIST(graphs, i);
+    if(!o)
+      throw GAPException("Flame graph options must be a record");
+    opts.push_back(readFlameGraphOptions(o));
+    GAPRecord r(o);
+    filenames.push_back(r.has("filename") ? GAP_get<std::string>(r.get("filename")) : "");
+    wanted[opts.back().tree()] = true;
+  }
+
+  FunctionTable functions;
+  StackTrace trees[4];
+  readFlameGraphTrees(stack_runtimes, functions, trees, wanted);
+
+  Obj ret = NEW_PLIST(T_PLIST, opts.size());
+  SET_LEN_PLIST(ret, opts.size());
+  for(size_t i = 0; i < opts.size(); ++i)
+  {
+    std::string svg;
+    writeFlameGraph(svg, &trees[opts[i].tree()], functions, opts[i]);
+    if(filenames[i].empty())
+    {
+      SET_ELM_PLIST(ret, i + 1, GAP_make(svg));
+      CHANGED_BAG(ret);
+      continue;
+    }
+    OutStream out(filenames[i].c_str(), endsWithgz(filenames[i].c_str()));
+    if(out.fail())
+      throw GAPException("Unable to open file " + filenames[i]);
+    size_t written = fwrite(svg.data(), 1, svg.size(), out.stream);
+    if(!out.close() || written != svg.size())
+      throw GAPException("Unable to write file " + filenames[i]);
+    SET_ELM_PLIST(ret, i + 1, True);
+  }
+  return ret;
+}
+
+// Writes the call tree in the 'folded' format read by flamegraph.pl, with
+// one line "f1;f2;...;fn weight" for each path through the tree. Paths are
+// visited depth first, so each line shares a prefix with the one before it,
+// and only the end of the line is rebuilt.
+struct FoldedStackWriter
+{
+  FILE* out;
+  std::string buf;
+  const FunctionTable& functions;
+  const FlameWeigher& weigher;
+  // The name of each function, formatted once
+  std::vector<std::string> names;
+  std::string line;
+
+  FoldedStackWriter(FILE* _out, const FunctionTable& _functions, const FlameWeigher& _weigher)
+    : out(_out), functions(_functions), weigher(_weigher), names(_functions.size())
+  { }
+
+  // Write 'buf' to 'out' once it is large enough, or if 'force' is true
+  void flush(bool force)
+  {
+    if(!out || (!force && buf.size() < (1 << 20)))
+      return;
+    if(fwrite(buf.data(), 1, buf.size(), out) != buf.size())
+      throw GAPException("Unable to write flame graph input");
+    buf.clear();
+  }
+
+  void node(StackTrace* st)
+  {
+    Int w = weigher.node(st);
+    if(w > 0)
+    {
+      char count[32];
+      snprintf(count, sizeof(count), " %ld\n", (long)w);
+      buf += line;
+      buf += count;
+      flush(false);
+    }
+    std::vector<std::pair<Int, StackTrace*> > children = sortedChildren(st, functions);
+    size_t prefix = line.size();
+    for(size_t i = 0; i < children.size(); ++i)
+    {
+      Int id = children[i].first;
+      if(names[id].empty())
+        names[id] = flameFunctionName(functions[id]);
+      if(prefix > 0)
+        line += ';';
+      line += names[id];
+      node(children[i].second);
+      line.resize(prefix);
+    }
+  }
+};
+
+// Write 'stack_runtimes' in the folded format to 'filename' (compressed
+// if it ends in '.gz'), or return it as a string if 'filename' is fail.
+// Only the 'weight' of the record 'options' is used.
+static Obj writeFoldedStacks(Obj stack_runtimes, Obj filename, Obj options)
+{
+  FlameWeight weight = readFlameGraphOptions(options).weight;
+  FunctionTable functions;
+  StackTrace root;
+  readStackRuntimes(stack_runtimes, functions, root, false);
+  FlameWeigher weigher(&root, weight);
+
+  if(filename == Fail)
+  {
+    FoldedStackWriter writer(0, functions, weigher);
+    writer.node(&root);
+    return GAP_make(writer.buf);
+  }
+
+  std::string name = GAP_get<std::string>(filename);
+  OutStream out(name.c_str(), endsWithgz(name.c_str()));
+  if(out.fail())
+    throw GAPException("Unable to open file " + name);
+  FoldedStackWriter writer(out.stream, functions, weigher);
+  writer.node(&root);
+  writer.flush(true);
+  if(!out.close())
+    throw GAPException("Unable to write file " + name);
+  return True;
+}
+
+// Draw the 'stacks' of a comparison of two profiles, from DIFF_PROFILES,
+// as a differential flame graph. Frames are as wide as the ticks after,
+// and coloured by how the ticks of each frame itself changed. 'options' is
+// a record of flame graph options as for WRITE_FLAME_GRAPHS, though only
+// ticks can be shown. If it has a 'filename' the graph is written to that
+// file, and otherwise it is returned as a string.
+static Obj writeDiffFlameGraph(Obj stacks, Obj options)
+{
+  if(!IS_SMALL_LIST(stacks))
+    throw GAPException("stacks must be a list");
+  FlameGraphOptions opts = readFlameGraphOptions(options);
+  if(opts.weight != FlameTicks)
+    throw GAPException("Differential flame graphs can only show ticks");
+  GAPRecord r(options);
+  std::string filename = r.has("filename") ? GAP_get<std::string>(r.get("filename")) : "";
+
+  FunctionTable functions;
+  StackTrace root;
+  root.setupChildren();
+  std::map<const StackTrace*, Int> deltas;
+  std::vector<Int> path;
+  for(Int i = 1; i <= LEN_LIST(stacks); ++i)
+  {
+    Obj entry = ELM0_LIST(stacks, i);
+    if(!entry || !IS_REC(entry))
+      throw GAPException("Invalid entry in stacks");
+    GAPRecord e(entry);
+    Obj stack = e.get("stack");
+    if(!IS_SMALL_LIST(stack))
+      throw GAPException("Invalid entry in stacks");
+    // Time outside any function is not drawn, as flamegraph.pl did not
+    // draw it either
+    if(LEN_LIST(stack) == 0)
+      continue;
+    path.clear();
+    for(Int j = 1; j <= LEN_LIST(stack); ++j)
+      path.push_back(functions.intern(GAP_get<FullFunction>(ELM_LIST(stack, j))));
+
+    StackTrace* st = &root;
+    Int prev = -1;
+    for(size_t j = 0; j < path.size(); ++j)
+    {
+      Int id = opts.reverse ? path[path.size() - 1 - j] : path[j];
+      if(opts.squash && id == prev)
+        continue;
+      prev = id;
+      st = &(st->children->insert(std::make_pair(id, StackTrace(st))).first->second);
+      st->setupChildren();
+    }
+    Int before = GAP_get<Int>(e.get("before"));
+    Int after = GAP_get<Int>(e.get("after"));
+    st->runtime += after;
+    deltas[st] += after - before;
+  }
+
+  std::string svg;
+  writeFlameGraph(svg, &root, functions, opts, &deltas);
+  if(filename.empty())
+    return GAP_make(svg);
+  OutStream out(filename.c_str(), endsWithgz(filename.c_str()));
+  if(out.fail())
+    throw GAPException("Unable to open file " + filename);
+  size_t written = fwrite(svg.data(), 1, svg.size(), out.stream);
+  if(!out.close() || written != svg.size())
+    throw GAPException("Unable to write file " + filename);
+  return True;
+}
+
+// Writes a call tree for the canvas flame graph viewer (data/flamegraph.js),
+// split into chunks so huge trees can be viewed. The tree goes into
+// 'data.js', which calls flameChunk(0, ...), and 'chunks/N.js', each of
+// which calls flameChunk(N, ...). Chunks are loaded with <script> tags,
+// which work for files opened directly from disk.
+//
+// Each node is written as [function, weight] if it has no children,
+// [function, weight, [children]], or [function, weight, chunk, k] if its
+// children are the k'th entry of chunk 'chunk'. The root has function -1.
+// Children are written sorted by name, the order the SVG flame graphs draw
+// them in, so both show a profile the same way.
+struct FlameChunkWriter
+{
+  // The subtrees whose children go into one chunk
+  struct Job
+  {
+    Int id;
+    std::vector<StackTrace*> roots;
+  };
+
+  std::string dir;
+  Int chunk_nodes;
+  FlameWeight weight;
+  Int next_chunk;
+  // Chunks which still need to be written. New subtrees are added to the
+  // last one while it has space, which has 'last_job_nodes' nodes.
+  std::deque<Job> jobs;
+  Int last_job_nodes;
+  // The total weight and number of nodes in each subtree
+  std::map<const StackTrace*, std::pair<Int, Int> > weights;
+  // The name of each function
+  std::vector<std::string> names;
+
+  FlameChunkWriter(const std::string& _dir, Int _chunk_nodes, FlameWeight _weight)
+    : dir(_dir), chunk_nodes(_chunk_nodes), weight(_weight), next_chunk(1), last_job_nodes(0)
+  { }
+
+  std::pair<Int, Int> weigh(const StackTrace* st, const FlameWeigher& weigher)
+  {
+    std::pair<Int, Int> w(weigher.node(st), 1);
+    if(st->children)
+    {
+      for(std::map<Int, StackTrace>::const_iterator it = st->children->begin();
+          it != st->children->end(); ++it)
+      {
+        std::pair<Int, Int> child = weigh(&(it->second), weigher);
+        w.first += child.first;
+        w.second += child.second;
+      }
+    }
+    weights[st] = w;
+    return w;
+  }
+
+  static bool hasChildren(const StackTrace* st)
+  { return st->children && !st->children->empty(); }
+
+  void writeNode(FILE* out, Int id, StackTrace* st, const std::set<StackTrace*>& expanded,
+                 const std::map<StackTrace*, std::pair<Int, Int> >& stubs)
+  {
+    fprintf(out, "[%ld,%ld", (long)id, (long)weights[st].first);
+    if(expanded.count(st))
+    {
+      putc(',', out);
+      writeChildren(out, st, expanded, stubs);
+    }
+    else if(hasChildren(st))
+    {
+      const std::pair<Int, Int>& stub = stubs.find(st)->second;
+      fprintf(out, ",%ld,%ld", (long)stub.first, (long)stub.second);
+    }
+    putc(']', out);
+  }
+
+  void writeChildren(FILE* out, StackTrace* st, const std::set<StackTrace*>& expanded,
+                     const std::map<StackTrace*, std::pair<Int, Int> >& stubs)
+  {
+    putc('[', out);
+    if(st->children)
+    {
+      std::vector<FlameChild> children;
+      for(std::map<Int, StackTrace>::iterator it = st->children->begin();
+          it != st->children->end(); ++it)
+        children.push_back(FlameChild(&names[it->first], it->first, &(it->second), 0));
+      std::sort(children.begin(), children.end());
+      for(size_t i = 0; i < children.size(); ++i)
+      {
+        if(i > 0)
+          putc(',', out);
+        writeNode(out, children[i].id, children[i].st, expanded, stubs);
+      }
+    }
+    putc(']', out);
+  }
+
+  // Write the chunk for 'job' to 'out', and queue the chunks it refers to
+  void writeChunk(FILE* out, const Job& job)
+  {
+    // Expand the nodes nearest the roots first, until the chunk is full
+    std::set<StackTrace*> expanded(job.roots.begin(), job.roots.end());
+    std::deque<StackTrace*> queue;
+    std::vector<StackTrace*> stubbed;
+    Int nodes = 0;
+    for(size_t i = 0; i < job.roots.size(); ++i)
+    {
+      for(std::map<Int, StackTrace>::iterator it = job.roots[i]->children->begin();
+          it != job.roots[i]->children->end(); ++it)
+      {
+        queue.push_back(&(it->second));
+        nodes++;
+      }
+    }
+    while(!queue.empty())
+    {
+      StackTrace* st = queue.front();
+      queue.pop_front();
+      if(!hasChildren(st))
+        continue;
+      if(nodes + (Int)st->children->size() > chunk_nodes)
+      {
+        stubbed.push_back(st);
+        continue;
+      }
+      expanded.insert(st);
+      for(std::map<Int, StackTrace>::iterator it = st->children->begin();
+          it != st->children->end(); ++it)
+      {
+        queue.push_back(&(it->second));
+        nodes++;
+      }
+    }
+
+    // Put small subtrees which were left out together in one chunk
+    std::map<StackTrace*, std::pair<Int, Int> > stubs;
+    for(size_t i = 0; i < stubbed.size(); ++i)
+    {
+      Int size = weights[stubbed[i]].second - 1;
+      if(jobs.empty() || last_job_nodes + size > chunk_nodes)
+      {
+        Job j;
+        j.id = next_chunk++;
+        jobs.push_back(j);
+        last_job_nodes = 0;
+      }
+      stubs[stubbed[i]] = std::make_pair(jobs.back().id, (Int)jobs.back().roots.size());
+      jobs.back().roots.push_back(stubbed[i]);
+      last_job_nodes += size;
+    }
+
+    fprintf(out, "flameChunk(%ld,[", (long)job.id);
+    for(size_t i = 0; i < job.roots.size(); ++i)
+    {
+      if(i > 0)
+        putc(',', out);
+      writeChildren(out, job.roots[i], expanded, stubs);
+    }
+    fputs("]);\n", out);
+  }
+
+  void write(StackTrace* root, const FunctionTable& functions, const std::string& title,
+             const std::string& unit)
+  {
+    std::string chunkdir = dir + "/chunks";
+    if((mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) ||
+       (mkdir(chunkdir.c_str(), 0755) != 0 && errno != EEXIST))
+      throw GAPException("Unable to create directory " + chunkdir);
+
+    Int total = weigh(root, FlameWeigher(root, weight)).first;
+    std::string dataname = dir + "/data.js";
+    FILE* out = fopen(dataname.c_str(), "w");
+    if(!out)
+      throw GAPException("Unable to open file " + dataname);
+    fputs("var flameData = {\"title\":", out);
+    writeJsonString(out, title);
+    fputs(",\"unit\":", out);
+    writeJsonString(out, unit);
+    fprintf(out, ",\"total\":%ld,\"functions\":[", (long)total);
+    for(Int id = 0; id < functions.size(); ++id)
+    {
+      if(id > 0)
+        putc(',', out);
+      names.push_back(flameFunctionName(functions[id]));
+      writeJsonString(out, names.back());
+    }
+    fputs("]};\n", out);
+    Job first;
+    first.id = 0;
+    first.roots.push_back(root);
+    writeChunk(out, first);
+    if(fclose(out) != 0)
+      throw GAPException("Unable to write file " + dataname);
+
+    while(!jobs.empty())
+    {
+      Job job = jobs.front();
+      jobs.pop_front();
+      std::ostringstream name;
+      name << chunkdir << "/" << job.id << ".js";
+      out = fopen(name.str().c_str(), "w");
+      if(!out)
+        throw GAPException("Unable to open file " + name.str());
+      writeChunk(out, job);
+      if(fclose(out) != 0)
+        throw GAPException("Unable to write file " + name.str());
+    }
+  }
+};
+
+// Write the data for a canvas flame graph of 'stack_runtimes' into the
+// directory 'dir'. 'options' is a record as for WRITE_FLAME_GRAPHS, which
+// may also have a component 'chunk_nodes', the most nodes in each chunk.
+static Obj writeFlameGraphData(Obj stack_runtimes, Obj dir, Obj options)
+{
+  FlameGraphOptions opts = readFlameGraphOptions(options);
+  GAPRecord r(options);
+  Int chunk_nodes = 10000;
+  if(r.has("chunk_nodes"))
+    chunk_nodes = GAP_get<Int>(r.get("chunk_nodes"));
+  if(chunk_nodes < 1)
+    throw GAPException("chunk_nodes must be a positive integer");
+
+  bool wanted[4] = { false, false, false, false };
+  wanted[opts.tree()] = true;
+  FunctionTable functions;
+  StackTrace trees[4];
+  readFlameGraphTrees(stack_runtimes, functions, trees, wanted);
+
+  FlameChunkWriter writer(GAP_get<std::string>(dir), chunk_nodes, opts.weight);
+  writer.write(&trees[opts.tree()], functions, opts.title, opts.unit());
+  return INTOBJ_INT(writer.next_chunk);
+}
+
+#endif
@@ -0,0 +1,110 @@
+//  Please refer to the COPYRIGHT file of the profiling package for details.
+//  SPDX-License-Identifier: MIT
+/*
+ * Encoding text for HTML, as done by HTMLEncodeString: '&' and '<' are
+ * escaped, and spaces and tabs become non-breaking spaces so indentation is
+ * kept. Most source text needs no escaping except for spaces, so we scan for
+ * the characters which need it 16 bytes at a time, copy the runs between
+ * them in one go, and work out the exact length of the output first.
+ *
+ * This file is included into profiling.cc, before coverage_html.h.
+ */
+
+#ifndef PROFILING_HTML_ENCODE_H
+#define PROFILING_HTML_ENCODE_H
+
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// How many more characters 'c' takes once encoded
+static inline size_t htmlEncodedExtra(char c)
+{
+  switch(c)
+  {
+    case '&': return 4;       // &amp;
+    case '<': return 3;       // &lt;
+    case ' ': return 5;       // &nbsp;
+    case '\t': return 8 * 6 - 1;
+    default: return 0;
+  }
+}
+
+// The position of the first character from 'i' onwards in 's' which needs
+// encoding, or 'len' if there is none
+static inline size_t nextHtmlSpecial(const char* s, size_t i, size_t len)
+{
+#ifdef __SSE2__
+  const __m128i amp = _mm_set1_epi8('&');
+  const __m128i lt = _mm_set1_epi8('<');
+  const __m128i space = _mm_set1_epi8(' ');
+  const __m128i tab = _mm_set1_epi8('\t');
+  for(; i + 16 <= len; i += 16)
+  {
+    __m128i block = _mm_loadu_si128((const __m128i*)(s + i));
+    __m128i found = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(block, amp), _mm_cmpeq_epi8(block, lt)),
+        _mm_or_si128(_mm_cmpeq_epi8(block, space), _mm_cmpeq_epi8(block, tab)));
+    int mask = _mm_movemask_epi8(found);
+    if(mask != 0)
+      return i + __builtin_ctz(mask);
+  }
+#endif
+  for(; i < len; ++i)
+  {
+    if(htmlEncodedExtra(s[i]) != 0)
+      return i;
+  }
+  return len;
+}
+
+// The length of 's' once encoded
+static size_t htmlEncodedLength(const char* s, size_t len)
+{
+  size_t total = len;
+  for(size_t i = nextHtmlSpecial(s, 0, len); i < len; i = nextHtmlSpecial(s, i + 1, len))
+    total += htmlEncodedExtra(s[i]);
+  return total;
+}
+
+// Write 's' encoded to 'out', which must have room for
+// htmlEncodedLength(s, len) characters. Returns the end of the output.
+static char* htmlEncodeInto(char* out, const char* s, size_t len)
+{
+  size_t i = 0;
+  while(i < len)
+  {
+    size_t special = nextHtmlSpecial(s, i, len);
+    memcpy(out, s + i, special - i);
+    out += special - i;
+    if(special == len)
+      break;
+    switch(s[special])
+    {
+      case '&': memcpy(out, "&amp;", 5); out += 5; break;
+      case '<': memcpy(out, "&lt;", 4); out += 4; break;
+      case ' ': memcpy(out, "&nbsp;", 6); out += 6; break;
+      case '\t':
+        for(int j = 0; j < 8; ++j)
+        {
+          memcpy(out, "&nbsp;", 6);
+          out += 6;
+        }
+        break;
+    }
+    i = special + 1;
+  }
+  return out;
+}
+
+// Append 's' to 'out', encoded as by HTMLEncodeString
+static void appendHtmlEncoded(std::string& out, const char* s, size_t len)
+{
+  size_t start = out.size();
+  out.resize(start + htmlEncodedLength(s, len));
+  if(len > 0)
+    htmlEncodeInto(&out[start], s, len);
+}
+
+#endif
@@ -0,0 +1,251 @@
+//  Please refer to the COPYRIGHT file of the profiling package for details.
+//  SPDX-License-Identifier: MIT
+/*
+ * Output profiles in pprof's profile.proto format. The format is described at
+ * https://github.com/google/pprof/blob/main/proto/profile.proto
+ *
+ * We only need to write a few simple messages, so rather than depend on
+ * protobuf we encode them by hand.
+ *
+ * This file is included into profiling.cc, after FunctionTable and
+ * LineSample are defined.
+ */
+
+#ifndef PROFILING_PPROF_H
+#define PROFILING_PPROF_H
+
+// Builds a single protobuf message in memory
+struct ProtoWriter
+{
+  std::string buf;
+
+  void varint(unsigned long long v)
+  {
+    while(v >= 0x80)
+    {
+      buf.push_back((char)((v & 0x7f) | 0x80));
+      v >>= 7;
+    }
+    buf.push_back((char)v);
+  }
+
+  void tag(int field, int wiretype)
+  { varint(((unsigned long long)field << 3) | wiretype); }
+
+  // Protobuf leaves out fields which are zero
+  void int64(int field, long long v)
+  {
+    if(v == 0)
+      return;
+    tag(field, 0);
+    varint((unsigned long long)v);
+  }
+
+  void bytes(int field, const std::string& s)
+  {
+    tag(field, 2);
+    varint(s.size());
+    buf.append(s);
+  }
+
+  void message(int field, const ProtoWriter& p)
+  { bytes(field, p.buf); }
+
+  void packed(int field, const std::vector<long long>& v)
+  {
+    ProtoWriter p;
+    for(size_t i = 0; i < v.size(); ++i)
+      p.varint((unsigned long long)v[i]);
+    bytes(field, p.buf);
+  }
+};
+
+// profile.proto stores all strings in one table, and refers to them by
+// their position in it. The first string must be empty.
+struct PprofStrings
+{
+  std::map<std::string, Int> ids;
+  std::vector<std::string> strings;
+
+  PprofStrings()
+  { intern(""); }
+
+  Int intern(const std::string& s)
+  {
+    std::map<std::string, Int>::iterator it = ids.find(s);
+    if(it != ids.end())
+      return it->second;
+    Int id = strings.size();
+    ids.insert(std::make_pair(s, id));
+    strings.push_back(s);
+    return id;
+  }
+};
+
+// The function used for time spent outside of any function
+FullFunction topLevelFunction()
+{ return FullFunction("[top level]", "", 0, 0); }
+
+// The locations of profile.proto: one for each line of each function which
+// appears in a sample. Ids of 0 are not allowed, so ids start at 1.
+struct PprofLocations
+{
+  FunctionTable& functions;
+  std::map<std::pair<Int, Int>, Int> ids;
+  std::vector<std::pair<Int, Int> > locations;
+
+  PprofLocations(FunctionTable& _functions) : functions(_functions)
+  { }
+
+  Int intern(const FullFunction& f, Int line)
+  {
+    std::pair<Int, Int> key(functions.intern(f), line);
+    std::map<std::pair<Int, Int>, Int>::iterator it = ids.find(key);
+    if(it != ids.end())
+      return it->second;
+    locations.push_back(key);
+    ids.insert(std::make_pair(key, (Int)locations.size()));
+    return locations.size();
+  }
+};
+
+// Encode 'profile', a profile returned by READ_PROFILE_FROM_STREAM, as a
+// (not compressed) profile.proto. If the profile was read with line_stacks,
+// each entry of line_samples becomes one sample, so each frame is placed at
+// the line which was running in it. Otherwise each entry of stack_runtimes
+// becomes one sample, and each frame is placed at the first line of its
+// function. The value of each sample is the ticks spent there.
+static std::string encodePprof(Obj profile)
+{
+  GAPRecord r(profile);
+  Obj stack_runtimes = r.get("stack_runtimes");
+  if(!IS_SMALL_LIST(stack_runtimes))
+    throw GAPException("stack_runtimes must be a list");
+
+  std::string time_type = "Wall";
+  if(r.has("info"))
+  {
+    GAPRecord info(r.get("info"));
+    if(info.has("time_type") && IS_STRING(info.get("time_type")))
+      time_type = GAP_get<std::string>(info.get("time_type"));
+  }
+  // GAP counts bytes allocated when recording memory, and microseconds
+  // otherwise
+  std::string unit = time_type == "Memory" ? "bytes" : "microseconds";
+
+  // Start from the profile's own function table, so functions get the
+  // same ids in both.
+  FunctionTable functions;
+  if(r.has("functions"))
+  {
+    std::vector<FullFunction> funcs = GAP_get<std::vector<FullFunction> >(r.get("functions"));
+    for(size_t i = 0; i < funcs.size(); ++i)
+      functions.intern(funcs[i]);
+  }
+  PprofLocations locations(functions);
+
+  PprofStrings strings;
+  ProtoWriter out;
+
+  ProtoWriter sample_type;
+  sample_type.int64(1, strings.intern("ticks"));
+  sample_type.int64(2, strings.intern(unit));
+  out.message(1, sample_type);
+
+  // pprof wants the innermost frame of each sample first
+  std::vector<long long> frames;
+  if(r.has("line_samples"))
+  {
+    std::vector<LineSample> samples = GAP_get<std::vector<LineSample> >(r.get("line_samples"));
+    for(size_t i = 0; i < samples.size(); ++i)
+    {
+      if(samples[i].second == 0)
+        continue;
+      const std::vector<std::pair<FullFunction, Int> >& path = samples[i].first;
+      frames.clear();
+      for(size_t j = path.size(); j-- > 0; )
+        frames.push_back(locations.intern(path[j].first, path[j].second));
+      if(frames.empty())
+        frames.push_back(locations.intern(topLevelFunction(), 0));
+
+      std::vector<long long> values(1, samples[i].second);
+      ProtoWriter sample;
+      sample.packed(1, frames);
+      sample.packed(2, values);
+      out.message(2, sample);
+    }
+  }
+  else
+  {
+    Int len = LEN_LIST(stack_runtimes);
+    for(Int i = 1; i <= len; ++i)
+    {
+      Obj entry = ELM0_LIST(stack_runtimes, i);
+      if(!entry || !IS_SMALL_LIST(entry) || LEN_LIST(entry) < 2)
+        throw GAPException("Invalid entry in stack_runtimes");
+      Int ticks = GAP_get<Int>(ELM_LIST(entry, 2));
+      if(ticks == 0)
+        continue;
+      Obj path = ELM_LIST(entry, 1);
+      if(!IS_SMALL_LIST(path))
+        throw GAPException("Invalid entry in stack_runtimes");
+
+      frames.clear();
+      for(Int j = LEN_LIST(path); j >= 1; --j)
+      {
+        FullFunction f = GAP_get<FullFunction>(ELM_LIST(path, j));
+        frames.push_back(locations.intern(f, f.line));
+      }
+      if(frames.empty())
+        frames.push_back(locations.intern(topLevelFunction(), 0));
+
+      std::vector<long long> values(1, ticks);
+      ProtoWriter sample;
+      sample.packed(1, frames);
+      sample.packed(2, values);
+      out.message(2, sample);
+    }
+  }
+
+  for(size_t i = 0; i < locations.locations.size(); ++i)
+  {
+    ProtoWriter line;
+    line.int64(1, locations.locations[i].first + 1);
+    line.int64(2, locations.locations[i].second);
+    ProtoWriter location;
+    location.int64(1, i + 1);
+    location.message(4, line);
+    out.message(4, location);
+  }
+
+  for(Int id = 0; id < functions.size(); ++id)
+  {
+    const FullFunction& f = functions[id];
+    ProtoWriter function;
+    function.int64(1, id + 1);
+    function.int64(2, strings.intern(f.name));
+    function.int64(3, strings.intern(f.name));
+    function.int64(4, strings.intern(f.filename));
+    function.int64(5, f.line);
+    out.message(5, function);
+  }
+
+  // The period type records if these were wall or CPU ticks, or memory
+  ProtoWriter period_type;
+  period_type.int64(1, strings.intern(time_type));
+  period_type.int64(2, strings.intern(unit));
+  Int comment = strings.intern("time_type: " + time_type);
+
+  // Everything which refers to a string is done, so the table can be written
+  for(size_t i = 0; i < strings.strings.size(); ++i)
+    out.bytes(6, strings.strings[i]);
+
+  out.message(11, period_type);
+  out.int64(12, 1);
+  std::vector<long long> comments(1, comment);
+  out.packed(13, comments);
+
+  return out.buf;
+}
+
+#endif
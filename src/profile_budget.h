@@ -0,0 +1,155 @@
+//  Please refer to the COPYRIGHT file of the profiling package for details.
+//  SPDX-License-Identifier: MIT
+/*
+ * Measure the time taken by groups of functions in a profile, so it can be
+ * checked against a performance budget.
+ *
+ * This file is included into profiling.cc, after profile_ticks.h.
+ */
+
+#ifndef PROFILING_PROFILE_BUDGET_H
+#define PROFILING_PROFILE_BUDGET_H
+
+#include <fnmatch.h>
+
+// Which functions a budget applies to: either every function with a
+// given name, or every function in files matching a glob.
+struct BudgetTarget
+{
+  bool by_name;
+  std::string pattern;
+
+  bool matches(const FullFunction& f) const
+  {
+    if(by_name)
+      return f.name == pattern;
+    return fnmatch(pattern.c_str(), f.filename.c_str(), 0) == 0;
+  }
+};
+
+struct BudgetMeasure
+{
+  // Ticks spent in the matched functions themselves
+  Int self;
+  // Ticks spent in stacks containing any of the matched functions
+  Int incl;
+  // Number of calls to the matched functions, or -1 if unknown
+  Int calls;
+  // Ticks in the whole profile
+  Int total;
+  // Number of functions matched
+  Int matched;
+
+  BudgetMeasure() : self(0), incl(0), calls(0), total(0), matched(0)
+  { }
+};
+
+namespace GAPdetail {
+template<>
+struct GAP_maker<BudgetMeasure>
+{
+  Obj operator()(const BudgetMeasure& m)
+  {
+    GAPRecord r;
+    r.set("self", m.self);
+    r.set("incl", m.incl);
+    if(m.calls >= 0)
+      r.set("calls", m.calls);
+    r.set("total", m.total);
+    r.set("matched", m.matched);
+    return r.raw_obj();
+  }
+};
+}
+
+static BudgetTarget readBudgetTarget(Obj o)
+{
+  if(!IS_REC(o))
+    throw GAPException("Each budget must be a record");
+  GAPRecord r(o);
+  BudgetTarget t;
+  if(r.has("function") && !r.has("file"))
+  {
+    t.by_name = true;
+    t.pattern = GAP_get<std::string>(r.get("function"));
+  }
+  else if(r.has("file") && !r.has("function"))
+  {
+    t.by_name = false;
+    t.pattern = GAP_get<std::string>(r.get("file"));
+  }
+  else
+    throw GAPException("Each budget must have exactly one of 'function' and 'file'");
+  return t;
+}
+
+// Measure each of 'budgets' (a list of records with a component 'function'
+// or 'file') in 'profile'.
+static Obj profileBudgetMeasures(Obj profile, Obj budgets)
+{
+  if(!IS_SMALL_LIST(budgets))
+    throw GAPException("Budgets must be a list");
+  std::vector<BudgetTarget> targets;
+  for(Int i = 1; i <= LEN_LIST(budgets); ++i)
+    targets.push_back(readBudgetTarget(ELM_LIST(budgets, i)));
+
+  // Keep the profile's ids, so they match function_durations
+  FunctionTable functions;
+  internProfileFunctions(profile, functions);
+  FunctionMatcher matcher(&functions, false);
+  ProfileTicks ticks;
+  collectProfileTicks(profile, matcher, ticks);
+
+  GAPRecord r(profile);
+  Obj durations = r.has("function_durations") ? r.get("function_durations") : 0;
+
+  Int total = 0;
+  for(std::map<std::vector<Int>, Int>::iterator it = ticks.stacks.begin();
+      it != ticks.stacks.end(); ++it)
+    total += it->second;
+
+  std::vector<BudgetMeasure> ret;
+  for(size_t t = 0; t < targets.size(); ++t)
+  {
+    BudgetMeasure m;
+    m.total = total;
+    if(!durations)
+      m.calls = -1;
+    std::vector<bool> matched(functions.size());
+    for(Int id = 0; id < functions.size(); ++id)
+    {
+      if(!targets[t].matches(functions[id]))
+        continue;
+      matched[id] = true;
+      m.matched++;
+      if(durations)
+      {
+        Obj d = ELM0_LIST(durations, id + 1);
+        if(d && IS_SMALL_LIST(d) && LEN_LIST(d) >= 1)
+          m.calls += GAP_get<Int>(ELM_LIST(d, 1));
+      }
+    }
+
+    for(std::map<std::vector<Int>, Int>::iterator it = ticks.stacks.begin();
+        it != ticks.stacks.end(); ++it)
+    {
+      const std::vector<Int>& path = it->first;
+      if(path.empty())
+        continue;
+      if(matched[path.back()])
+        m.self += it->second;
+      for(size_t j = 0; j < path.size(); ++j)
+      {
+        if(matched[path[j]])
+        {
+          m.incl += it->second;
+          break;
+        }
+      }
+    }
+    ret.push_back(m);
+  }
+  return GAP_make(ret);
+}
+
+#endif
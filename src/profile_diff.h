@@ -0,0 +1,199 @@
+//  Please refer to the COPYRIGHT file of the profiling package for details.
+//  SPDX-License-Identifier: MIT
+/*
+ * Compare two profiles, finding how much time changed for each function,
+ * line and stack of functions.
+ *
+ * This file is included into profiling.cc, after profile_ticks.h.
+ */
+
+#ifndef PROFILING_PROFILE_DIFF_H
+#define PROFILING_PROFILE_DIFF_H
+
+// Ticks spent in something, in the 'before' and 'after' profiles
+struct DiffTicks
+{
+  Int self_before, self_after, incl_before, incl_after;
+
+  DiffTicks() : self_before(0), self_after(0), incl_before(0), incl_after(0)
+  { }
+
+  Int selfDelta() const
+  { return self_after - self_before; }
+
+  Int inclDelta() const
+  { return incl_after - incl_before; }
+};
+
+struct FunctionDiff
+{
+  FullFunction function;
+  DiffTicks ticks;
+};
+
+struct LineDiff
+{
+  std::string filename;
+  Int line;
+  DiffTicks ticks;
+};
+
+struct StackDiff
+{
+  std::vector<FullFunction> stack;
+  DiffTicks ticks;
+};
+
+// Largest regressions first
+struct DiffOrder
+{
+  template<typename T>
+  bool operator()(const T& lhs, const T& rhs) const
+  {
+    if(lhs.ticks.inclDelta() != rhs.ticks.inclDelta())
+      return lhs.ticks.inclDelta() > rhs.ticks.inclDelta();
+    return lhs.ticks.selfDelta() > rhs.ticks.selfDelta();
+  }
+};
+
+namespace GAPdetail {
+static void setDiffTicks(GAPRecord& r, const DiffTicks& d)
+{
+  r.set("self_before", d.self_before);
+  r.set("self_after", d.self_after);
+  r.set("incl_before", d.incl_before);
+  r.set("incl_after", d.incl_after);
+}
+
+template<>
+struct GAP_maker<FunctionDiff>
+{
+  Obj operator()(const FunctionDiff& d)
+  {
+    GAPRecord r;
+    r.set("function", d.function);
+    setDiffTicks(r, d.ticks);
+    return r.raw_obj();
+  }
+};
+
+template<>
+struct GAP_maker<LineDiff>
+{
+  Obj operator()(const LineDiff& d)
+  {
+    GAPRecord r;
+    r.set("filename", d.filename);
+    r.set("line", d.line);
+    setDiffTicks(r, d.ticks);
+    return r.raw_obj();
+  }
+};
+
+template<>
+struct GAP_maker<StackDiff>
+{
+  Obj operator()(const StackDiff& d)
+  {
+    GAPRecord r;
+    r.set("stack", d.stack);
+    r.set("before", d.ticks.self_before);
+    r.set("after", d.ticks.self_after);
+    return r.raw_obj();
+  }
+};
+}
+
+// Add the ticks of one profile to the totals. 'after' says which profile this is.
+static void diffAddProfile(const ProfileTicks& ticks, bool after,
+                           std::map<Int, DiffTicks>& function_ticks,
+                           std::map<std::vector<Int>, DiffTicks>& stack_ticks,
+                           std::map<std::pair<std::string, Int>, DiffTicks>& line_ticks)
+{
+  for(std::map<Int, SelfInclTicks>::const_iterator it = ticks.functions.begin();
+      it != ticks.functions.end(); ++it)
+  {
+    DiffTicks& d = function_ticks[it->first];
+    (after ? d.self_after : d.self_before) += it->second.self;
+    (after ? d.incl_after : d.incl_before) += it->second.incl;
+  }
+  for(std::map<std::vector<Int>, Int>::const_iterator it = ticks.stacks.begin();
+      it != ticks.stacks.end(); ++it)
+  {
+    DiffTicks& d = stack_ticks[it->first];
+    (after ? d.self_after : d.self_before) += it->second;
+  }
+  for(std::map<std::pair<std::string, Int>, SelfInclTicks>::const_iterator it = ticks.lines.begin();
+      it != ticks.lines.end(); ++it)
+  {
+    DiffTicks& d = line_ticks[it->first];
+    (after ? d.self_after : d.self_before) += it->second.self;
+    (after ? d.incl_after : d.incl_before) += it->second.incl;
+  }
+}
+
+// Compare the profiles 'before' and 'after'. Returns a record with lists
+// 'functions', 'lines' and 'stacks' of the records made above.
+// 'functions' and 'lines' have the largest regressions first.
+static Obj diffProfiles(Obj before, Obj after)
+{
+  FunctionTable functions;
+  // Start from the 'after' profile's own function table, when it has one
+  internProfileFunctions(after, functions);
+
+  // The 'after' profile must be read first, so functions in 'before'
+  // are matched against it
+  ProfileTicks after_ticks, before_ticks;
+  FunctionMatcher after_matcher(&functions, false);
+  collectProfileTicks(after, after_matcher, after_ticks);
+  FunctionMatcher before_matcher(&functions, true);
+  collectProfileTicks(before, before_matcher, before_ticks);
+
+  std::map<Int, DiffTicks> function_ticks;
+  std::map<std::vector<Int>, DiffTicks> stack_ticks;
+  std::map<std::pair<std::string, Int>, DiffTicks> line_ticks;
+  diffAddProfile(after_ticks, true, function_ticks, stack_ticks, line_ticks);
+  diffAddProfile(before_ticks, false, function_ticks, stack_ticks, line_ticks);
+
+  std::vector<FunctionDiff> function_ret;
+  for(std::map<Int, DiffTicks>::iterator it = function_ticks.begin();
+      it != function_ticks.end(); ++it)
+  {
+    FunctionDiff d;
+    d.function = functions[it->first];
+    d.ticks = it->second;
+    function_ret.push_back(d);
+  }
+  std::stable_sort(function_ret.begin(), function_ret.end(), DiffOrder());
+
+  std::vector<LineDiff> line_ret;
+  for(std::map<std::pair<std::string, Int>, DiffTicks>::iterator it = line_ticks.begin();
+      it != line_ticks.end(); ++it)
+  {
+    LineDiff d;
+    d.filename = it->first.first;
+    d.line = it->first.second;
+    d.ticks = it->second;
+    line_ret.push_back(d);
+  }
+  std::stable_sort(line_ret.begin(), line_ret.end(), DiffOrder());
+
+  std::vector<StackDiff> stack_ret;
+  for(std::map<std::vector<Int>, DiffTicks>::iterator it = stack_ticks.begin();
+      it != stack_ticks.end(); ++it)
+  {
+    StackDiff d;
+    for(size_t j = 0; j < it->first.size(); ++j)
+      d.stack.push_back(functions[it->first[j]]);
+    d.ticks = it->second;
+    stack_ret.push_back(d);
+  }
+
+  GAPRecord r;
+  r.set("functions", function_ret);
+  r.set("lines", line_ret);
+  r.set("stacks", stack_ret);
+  return r.raw_obj();
+}
+
+#endif
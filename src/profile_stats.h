@@ -0,0 +1,288 @@
+//  Please refer to the COPYRIGHT file of the profiling package for details.
+//  SPDX-License-Identifier: MIT
+/*
+ * Statistics over several profiles of repeated runs of the same code,
+ * and tests for whether two sets of runs took different amounts of time.
+ *
+ * This file is included into profiling.cc, after profile_ticks.h.
+ */
+
+#ifndef PROFILING_PROFILE_STATS_H
+#define PROFILING_PROFILE_STATS_H
+
+#include <math.h>
+
+// The value of Student's t distribution for a two-sided 95% confidence
+// interval, with 'df' degrees of freedom. We round 'df' down, which gives
+// slightly wider intervals.
+static double tCritical95(double df)
+{
+  static const double table[30] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+  };
+  if(df < 1)
+    return table[0];
+  if(df < 31)
+    return table[(int)df - 1];
+  if(df < 40)
+    return 2.042;
+  if(df < 60)
+    return 2.021;
+  if(df < 120)
+    return 2.000;
+  return 1.960;
+}
+
+// The mean, standard deviation and 95% confidence interval of the mean
+// of some values. The confidence interval is mean +/- 'ci'.
+struct RunSummary
+{
+  Int runs;
+  double mean;
+  double sd;
+  double ci;
+
+  RunSummary() : runs(0), mean(0), sd(0), ci(0)
+  { }
+
+  RunSummary(const std::vector<Int>& values) : runs(values.size()), mean(0), sd(0), ci(0)
+  {
+    if(runs == 0)
+      return;
+    for(size_t i = 0; i < values.size(); ++i)
+      mean += values[i];
+    mean /= runs;
+    if(runs < 2)
+      return;
+    double sum_sq = 0;
+    for(size_t i = 0; i < values.size(); ++i)
+      sum_sq += (values[i] - mean) * (values[i] - mean);
+    sd = sqrt(sum_sq / (runs - 1));
+    ci = tCritical95(runs - 1) * sd / sqrt((double)runs);
+  }
+};
+
+// Welch's t-test, at the 95% level. We need at least two runs on each
+// side to know how noisy the runs are.
+static bool significantChange(const RunSummary& a, const RunSummary& b)
+{
+  if(a.runs < 2 || b.runs < 2)
+    return false;
+  double va = a.sd * a.sd / a.runs;
+  double vb = b.sd * b.sd / b.runs;
+  if(va + vb == 0)
+    return a.mean != b.mean;
+  double t = fabs(a.mean - b.mean) / sqrt(va + vb);
+  double df = (va + vb) * (va + vb) /
+              (va * va / (a.runs - 1) + vb * vb / (b.runs - 1));
+  return t > tCritical95(df);
+}
+
+// The self and inclusive ticks of something in each run of a set of runs
+struct RunTicks
+{
+  std::vector<Int> self;
+  std::vector<Int> incl;
+
+  RunTicks(size_t runs) : self(runs, 0), incl(runs, 0)
+  { }
+};
+
+// The statistics for a function or line in a baseline set of runs, and
+// optionally a candidate set of runs.
+struct RunStats
+{
+  FullFunction function;
+  std::string filename;
+  Int line;
+  bool is_function;
+  bool compare;
+  RunSummary self[2];
+  RunSummary incl[2];
+
+  double inclChange() const
+  { return incl[1].mean - incl[0].mean; }
+
+  bool inclSignificant() const
+  { return compare && significantChange(incl[0], incl[1]); }
+};
+
+// When comparing, show significant changes first, and then the largest
+// regressions. Otherwise show what took longest first.
+struct RunStatsOrder
+{
+  bool operator()(const RunStats& lhs, const RunStats& rhs) const
+  {
+    if(lhs.compare)
+    {
+      if(lhs.inclSignificant() != rhs.inclSignificant())
+        return lhs.inclSignificant();
+      return lhs.inclChange() > rhs.inclChange();
+    }
+    return lhs.incl[0].mean > rhs.incl[0].mean;
+  }
+};
+
+namespace GAPdetail {
+template<>
+struct GAP_maker<double>
+{
+  Obj operator()(double d) const
+  { return NEW_MACFLOAT(d); }
+};
+
+template<>
+struct GAP_maker<RunSummary>
+{
+  Obj operator()(const RunSummary& s)
+  {
+    GAPRecord r;
+    r.set("mean", s.mean);
+    r.set("sd", s.sd);
+    r.set("ci", s.ci);
+    return r.raw_obj();
+  }
+};
+
+template<>
+struct GAP_maker<RunStats>
+{
+  Obj operator()(const RunStats& s)
+  {
+    GAPRecord r;
+    if(s.is_function)
+      r.set("function", s.function);
+    else
+    {
+      r.set("filename", s.filename);
+      r.set("line", s.line);
+    }
+    if(s.compare)
+    {
+      GAPRecord baseline;
+      baseline.set("self", s.self[0]);
+      baseline.set("incl", s.incl[0]);
+      r.set("baseline", baseline);
+      GAPRecord candidate;
+      candidate.set("self", s.self[1]);
+      candidate.set("incl", s.incl[1]);
+      r.set("candidate", candidate);
+      r.set("self_change", s.self[1].mean - s.self[0].mean);
+      r.set("incl_change", s.inclChange());
+      r.set("self_significant", significantChange(s.self[0], s.self[1]));
+      r.set("incl_significant", s.inclSignificant());
+    }
+    else
+    {
+      r.set("self", s.self[0]);
+      r.set("incl", s.incl[0]);
+    }
+    return r.raw_obj();
+  }
+};
+}
+
+// Gather the ticks of every function and line in each profile of 'group'
+static void collectRunTicks(Obj group, Int first_run, Int total_runs,
+                            FunctionTable& functions,
+                            std::map<Int, RunTicks>& function_runs,
+                            std::map<std::pair<std::string, Int>, RunTicks>& line_runs)
+{
+  FunctionMatcher matcher(&functions, false);
+  for(Int i = 1; i <= LEN_LIST(group); ++i)
+  {
+    Obj profile = ELM0_LIST(group, i);
+    if(!profile || !IS_REC(profile))
+      throw GAPException("Profiles must be records");
+    ProfileTicks ticks;
+    collectProfileTicks(profile, matcher, ticks);
+    Int run = first_run + i - 1;
+    for(std::map<Int, SelfInclTicks>::iterator it = ticks.functions.begin();
+        it != ticks.functions.end(); ++it)
+    {
+      RunTicks& rt = function_runs.insert(std::make_pair(it->first, RunTicks(total_runs))).first->second;
+      rt.self[run] = it->second.self;
+      rt.incl[run] = it->second.incl;
+    }
+    for(std::map<std::pair<std::string, Int>, SelfInclTicks>::iterator it = ticks.lines.begin();
+        it != ticks.lines.end(); ++it)
+    {
+      RunTicks& rt = line_runs.insert(std::make_pair(it->first, RunTicks(total_runs))).first->second;
+      rt.self[run] = it->second.self;
+      rt.incl[run] = it->second.incl;
+    }
+  }
+}
+
+static void summariseRuns(const RunTicks& rt, Int baseline_runs, bool compare, RunStats& s)
+{
+  s.compare = compare;
+  std::vector<Int> self(rt.self.begin(), rt.self.begin() + baseline_runs);
+  std::vector<Int> incl(rt.incl.begin(), rt.incl.begin() + baseline_runs);
+  s.self[0] = RunSummary(self);
+  s.incl[0] = RunSummary(incl);
+  if(compare)
+  {
+    self.assign(rt.self.begin() + baseline_runs, rt.self.end());
+    incl.assign(rt.incl.begin() + baseline_runs, rt.incl.end());
+    s.self[1] = RunSummary(self);
+    s.incl[1] = RunSummary(incl);
+  }
+}
+
+// Find statistics for the lists of profiles 'baseline' and 'candidate'.
+// If 'candidate' is empty, we just find statistics for 'baseline'.
+static Obj profileRunStats(Obj baseline, Obj candidate)
+{
+  if(!IS_SMALL_LIST(baseline) || !IS_SMALL_LIST(candidate))
+    throw GAPException("Profiles must be given as a list");
+  Int baseline_runs = LEN_LIST(baseline);
+  Int candidate_runs = LEN_LIST(candidate);
+  if(baseline_runs == 0)
+    throw GAPException("At least one profile is required");
+  Int total_runs = baseline_runs + candidate_runs;
+  bool compare = candidate_runs > 0;
+
+  FunctionTable functions;
+  std::map<Int, RunTicks> function_runs;
+  std::map<std::pair<std::string, Int>, RunTicks> line_runs;
+  collectRunTicks(baseline, 0, total_runs, functions, function_runs, line_runs);
+  collectRunTicks(candidate, baseline_runs, total_runs, functions, function_runs, line_runs);
+
+  std::vector<RunStats> function_stats;
+  for(std::map<Int, RunTicks>::iterator it = function_runs.begin(); it != function_runs.end(); ++it)
+  {
+    RunStats s;
+    s.function = functions[it->first];
+    s.line = 0;
+    s.is_function = true;
+    summariseRuns(it->second, baseline_runs, compare, s);
+    function_stats.push_back(s);
+  }
+  std::stable_sort(function_stats.begin(), function_stats.end(), RunStatsOrder());
+
+  std::vector<RunStats> line_stats;
+  for(std::map<std::pair<std::string, Int>, RunTicks>::iterator it = line_runs.begin();
+      it != line_runs.end(); ++it)
+  {
+    RunStats s;
+    s.filename = it->first.first;
+    s.line = it->first.second;
+    s.is_function = false;
+    summariseRuns(it->second, baseline_runs, compare, s);
+    line_stats.push_back(s);
+  }
+  std::stable_sort(line_stats.begin(), line_stats.end(), RunStatsOrder());
+
+  GAPRecord r;
+  r.set("baseline_runs", baseline_runs);
+  if(compare)
+    r.set("candidate_runs", candidate_runs);
+  r.set("functions", function_stats);
+  r.set("lines", line_stats);
+  return r.raw_obj();
+}
+
+#endif
@@ -0,0 +1,235 @@
+//  Please refer to the COPYRIGHT file of the profiling package for details.
+//  SPDX-License-Identifier: MIT
+/*
+ * Find the time spent in each function, line and stack of functions of a
+ * profile which has already been read. This is used when comparing
+ * profiles.
+ *
+ * This file is included into profiling.cc, after FunctionTable is defined.
+ */
+
+#ifndef PROFILING_PROFILE_TICKS_H
+#define PROFILING_PROFILE_TICKS_H
+
+// Finds the function in a FunctionTable which matches a function from
+// another profile. Functions match if they have the same name, file
+// and starting line. If there is no such function, we accept a function
+// with the same name and file (choosing the one whose starting line is
+// closest), so small edits which move functions do not lose them.
+//
+// When matching like this, each function in the table is only matched
+// once, so different functions (for example, several nameless functions in
+// one file) are never added together. Functions which find no match are
+// added to the table.
+struct FunctionMatcher
+{
+  FunctionTable* functions;
+  // If false, only accept the same function
+  bool fuzzy;
+  // The functions in the table which have not been matched yet
+  std::map<std::pair<std::string, std::string>, std::vector<Int> > unmatched;
+  // The functions matched so far
+  std::map<FullFunction, Int> matched;
+
+  FunctionMatcher(FunctionTable* f, bool _fuzzy) : functions(f), fuzzy(_fuzzy)
+  {
+    for(Int i = 0; fuzzy && i < functions->size(); ++i)
+    {
+      const FullFunction& g = (*functions)[i];
+      unmatched[std::make_pair(g.name, g.filename)].push_back(i);
+    }
+  }
+
+  // How far the function 'id' is from 'f': the distance between their
+  // starting lines, and then if they end on different lines
+  std::pair<Int, bool> distance(const FullFunction& f, Int id) const
+  {
+    const FullFunction& g = (*functions)[id];
+    return std::make_pair(std::abs(g.line - f.line), g.endline != f.endline);
+  }
+
+  // Match 'f' to the closest unmatched function with the same name and
+  // file, and return true. If 'same_line' is true it must start on the
+  // same line, and if 'same_end' is true it must also end on the same line.
+  bool take(const FullFunction& f, bool same_line, bool same_end)
+  {
+    std::map<std::pair<std::string, std::string>, std::vector<Int> >::iterator it =
+      unmatched.find(std::make_pair(f.name, f.filename));
+    if(it == unmatched.end() || it->second.empty())
+      return false;
+    std::vector<Int>& ids = it->second;
+    size_t best = 0;
+    for(size_t i = 1; i < ids.size(); ++i)
+    {
+      if(distance(f, ids[i]) < distance(f, ids[best]))
+        best = i;
+    }
+    const FullFunction& g = (*functions)[ids[best]];
+    if((same_line && g.line != f.line) || (same_end && g.endline != f.endline))
+      return false;
+    matched[f] = ids[best];
+    ids.erase(ids.begin() + best);
+    return true;
+  }
+
+  // Match the functions in 'fs' which are in the table exactly, or at the
+  // same line, so functions which moved can not be matched to them first
+  void matchUnmoved(const std::set<FullFunction>& fs)
+  {
+    std::set<FullFunction>::const_iterator it;
+    for(it = fs.begin(); it != fs.end(); ++it)
+    {
+      if(matched.find(*it) == matched.end())
+        take(*it, true, true);
+    }
+    for(it = fs.begin(); it != fs.end(); ++it)
+    {
+      if(matched.find(*it) == matched.end())
+        take(*it, true, false);
+    }
+  }
+
+  Int match(const FullFunction& f)
+  {
+    if(!fuzzy)
+      return functions->intern(f);
+    std::map<FullFunction, Int>::iterator it = matched.find(f);
+    if(it != matched.end())
+      return it->second;
+    if(take(f, false, false))
+      return matched[f];
+    Int id = functions->intern(f);
+    matched[f] = id;
+    return id;
+  }
+};
+
+// Ticks spent in something itself, and including the functions it called
+struct SelfInclTicks
+{
+  Int self;
+  Int incl;
+
+  SelfInclTicks() : self(0), incl(0)
+  { }
+};
+
+struct ProfileTicks
+{
+  // Indexed by function id
+  std::map<Int, SelfInclTicks> functions;
+  // The ticks spent in each stack of function ids
+  std::map<std::vector<Int>, Int> stacks;
+  // Indexed by (filename, line)
+  std::map<std::pair<std::string, Int>, SelfInclTicks> lines;
+};
+
+// Add the functions of a profile's own function table, if it has one, to
+// 'functions', so they keep the same ids
+static void internProfileFunctions(Obj profile, FunctionTable& functions)
+{
+  GAPRecord r(profile);
+  if(r.has("functions"))
+  {
+    std::vector<FullFunction> funcs = GAP_get<std::vector<FullFunction> >(r.get("functions"));
+    for(size_t i = 0; i < funcs.size(); ++i)
+      functions.intern(funcs[i]);
+  }
+}
+
+// The functions in the stacks of 'stack_runtimes'
+static std::set<FullFunction> profileFunctions(Obj stack_runtimes)
+{
+  std::set<FullFunction> ret;
+  for(Int i = 1; i <= LEN_LIST(stack_runtimes); ++i)
+  {
+    Obj entry = ELM0_LIST(stack_runtimes, i);
+    if(!entry || !IS_SMALL_LIST(entry) || LEN_LIST(entry) < 2)
+      throw GAPException("Invalid entry in stack_runtimes");
+    Obj gap_path = ELM_LIST(entry, 1);
+    if(!IS_SMALL_LIST(gap_path))
+      throw GAPException("Invalid entry in stack_runtimes");
+    for(Int j = 1; j <= LEN_LIST(gap_path); ++j)
+      ret.insert(GAP_get<FullFunction>(ELM_LIST(gap_path, j)));
+  }
+  return ret;
+}
+
+static void collectProfileTicks(Obj profile, FunctionMatcher& matcher, ProfileTicks& out)
+{
+  GAPRecord r(profile);
+  Obj stack_runtimes = r.get("stack_runtimes");
+  if(!IS_SMALL_LIST(stack_runtimes))
+    throw GAPException("stack_runtimes must be a list");
+
+  // Each entry of stack_runtimes has a different stack, and we look up the
+  // same functions many times, so remember the ones we have seen.
+  std::map<FullFunction, Int> seen;
+  if(matcher.fuzzy)
+    matcher.matchUnmoved(profileFunctions(stack_runtimes));
+  std::vector<Int> path;
+  std::set<Int> in_path;
+  for(Int i = 1; i <= LEN_LIST(stack_runtimes); ++i)
+  {
+    Obj entry = ELM0_LIST(stack_runtimes, i);
+    if(!entry || !IS_SMALL_LIST(entry) || LEN_LIST(entry) < 2)
+      throw GAPException("Invalid entry in stack_runtimes");
+    Obj gap_path = ELM_LIST(entry, 1);
+    if(!IS_SMALL_LIST(gap_path))
+      throw GAPException("Invalid entry in stack_runtimes");
+    Int ticks = GAP_get<Int>(ELM_LIST(entry, 2));
+
+    path.clear();
+    for(Int j = 1; j <= LEN_LIST(gap_path); ++j)
+    {
+      FullFunction f = GAP_get<FullFunction>(ELM_LIST(gap_path, j));
+      std::map<FullFunction, Int>::iterator it = seen.find(f);
+      if(it == seen.end())
+        it = seen.insert(std::make_pair(f, matcher.match(f))).first;
+      path.push_back(it->second);
+    }
+
+    out.stacks[path] += ticks;
+
+    if(path.empty())
+      continue;
+
+    out.functions[path.back()].self += ticks;
+    // Recursive functions only get these ticks once
+    in_path.clear();
+    in_path.insert(path.begin(), path.end());
+    for(std::set<Int>::iterator it = in_path.begin(); it != in_path.end(); ++it)
+      out.functions[*it].incl += ticks;
+  }
+
+  Obj line_info = r.get("line_info");
+  if(!IS_SMALL_LIST(line_info))
+    throw GAPException("Invalid profile");
+  for(Int i = 1; i <= LEN_LIST(line_info); ++i)
+  {
+    Obj entry = ELM0_LIST(line_info, i);
+    if(!entry || !IS_SMALL_LIST(entry) || LEN_LIST(entry) != 2)
+      throw GAPException("Invalid profile");
+    std::string filename = GAP_get<std::string>(ELM_LIST(entry, 1));
+    Obj lines = ELM_LIST(entry, 2);
+    if(!IS_SMALL_LIST(lines))
+      throw GAPException("Invalid profile");
+    for(Int line = 1; line <= LEN_LIST(lines); ++line)
+    {
+      Obj info = ELM0_LIST(lines, line);
+      if(!info)
+        continue;
+      if(!IS_SMALL_LIST(info) || LEN_LIST(info) < 4)
+        throw GAPException("Invalid profile");
+      Int self = GAP_get<Int>(ELM_LIST(info, 3));
+      Int children = GAP_get<Int>(ELM_LIST(info, 4));
+      if(self == 0 && children == 0)
+        continue;
+      SelfInclTicks& t = out.lines[std::make_pair(filename, line)];
+      t.self += self;
+      t.incl += self + children;
+    }
+  }
+}
+
+#endif
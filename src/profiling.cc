@@ -12,6 +12,7 @@
 
 #include <fcntl.h>
 #include <stdio.h>
+#include <time.h>
 #include <unistd.h>
 #include <sys/stat.h>
 
@@ -102,6 +103,24 @@ struct GAP_maker<FullFunction>
 };
 }
 
+namespace GAPdetail {
+template<>
+struct GAP_getter<FullFunction>
+{
+  bool isa(Obj recval) const
+  { return IS_REC(recval); }
+
+  FullFunction operator()(Obj recval) const
+  {
+    GAPRecord r(recval);
+    return FullFunction(GAP_get<std::string>(r.get("name")),
+                        GAP_get<std::string>(r.get("filename")),
+                        GAP_get<Int>(r.get("line")),
+                        GAP_get<Int>(r.get("endline")));
+  }
+};
+}
+
 struct Location
 {
   std::string filename;
@@ -143,65 +162,687 @@ struct GAP_maker<Location>
 FullFunction buildFunctionName(const JsonParse& jp)
 { return FullFunction(jp.Fun, jp.File, jp.Line, jp.EndLine); }
 
+// Gives each distinct function a small integer id, so the call tree
+// can refer to functions without storing a copy of each name.
+struct FunctionTable
+{
+  std::map<FullFunction, Int> ids;
+  std::vector<FullFunction> functions;
+
+  Int intern(const FullFunction& f)
+  {
+    std::map<FullFunction, Int>::iterator it = ids.find(f);
+    if(it != ids.end())
+      return it->second;
+    Int id = functions.size();
+    ids.insert(std::make_pair(f, id));
+    functions.push_back(f);
+    return id;
+  }
+
+  const FullFunction& operator[](Int id) const
+  { return functions[id]; }
+
+  Int size() const
+  { return functions.size(); }
+};
+
+// The function used to represent parts of the call tree which were
+// thrown away to stay within a memory budget.
+FullFunction otherFunction()
+{ return FullFunction("[other]", "", 0, 0); }
+
 // We lazily set up 'children' because we can't be bothered using
-// a shared_ptr
+// a shared_ptr. Children are indexed by their id in a FunctionTable.
 struct StackTrace
 {
-    int runtime;
-    int calls;
-    std::map<FullFunction, StackTrace>* children;
+    Int runtime;
+    Int calls;
+    std::map<Int, StackTrace>* children;
     StackTrace* parent;
+    // The part of 'runtime' spent on each line, if this is recorded
+    std::map<Int, Int>* line_runtimes;
 
     StackTrace() : runtime(0), calls(0),
-    children(NULL), parent(NULL)
+    children(NULL), parent(NULL), line_runtimes(NULL)
     { }
 
     StackTrace(StackTrace* p) : runtime(0), calls(0),
-    children(NULL), parent(p)
+    children(NULL), parent(p), line_runtimes(NULL)
     { }
 
     void setupChildren()
     {
       if(!children)
-        children = new std::map<FullFunction, StackTrace>;
+        children = new std::map<Int, StackTrace>;
     }
 
     ~StackTrace()
     {
       if(children)
         delete children;
+      if(line_runtimes)
+        delete line_runtimes;
     }
 
     StackTrace(const StackTrace& st) :
-    runtime(st.runtime), calls(st.calls), children(st.children), parent(st.parent)
-    { assert(!children); }
+    runtime(st.runtime), calls(st.calls), children(st.children), parent(st.parent),
+    line_runtimes(st.line_runtimes)
+    { assert(!children && !line_runtimes); }
 
 };
 
+// Orders the children of a StackTrace by their function, rather than id
+struct ChildOrder
+{
+    const FunctionTable* functions;
+    ChildOrder(const FunctionTable* f) : functions(f) { }
 
-void dumpRuntimes_in(StackTrace* st,
-                     std::vector<std::pair<std::vector<FullFunction>, Int > >& ret,
-                     std::vector<FullFunction>& stack)
+    bool operator()(const std::pair<Int, StackTrace*>& lhs,
+                    const std::pair<Int, StackTrace*>& rhs) const
+    { return (*functions)[lhs.first] < (*functions)[rhs.first]; }
+};
+
+std::vector<std::pair<Int, StackTrace*> > sortedChildren(StackTrace* st,
+                                                         const FunctionTable& functions)
 {
-    ret.push_back(std::make_pair(stack, st->runtime));
-    for(std::map<FullFunction, StackTrace>::iterator it = st->children->begin();
+    std::vector<std::pair<Int, StackTrace*> > children;
+    if(!st->children)
+        return children;
+    for(std::map<Int, StackTrace>::iterator it = st->children->begin();
         it != st->children->end();
         ++it)
     {
-        stack.push_back(it->first);
-        dumpRuntimes_in(&(it->second), ret, stack);
+        children.push_back(std::make_pair(it->first, &(it->second)));
+    }
+    std::sort(children.begin(), children.end(), ChildOrder(&functions));
+    return children;
+}
+
+// One node of a call tree, as an entry [stack, ticks, calls] of 'stack_runtimes'
+struct StackRuntime
+{
+    std::vector<FullFunction> stack;
+    Int runtime;
+    Int calls;
+
+    StackRuntime(const std::vector<FullFunction>& s, Int r, Int c)
+    : stack(s), runtime(r), calls(c)
+    { }
+};
+
+namespace GAPdetail {
+template<>
+struct GAP_maker<StackRuntime>
+{
+  Obj operator()(const StackRuntime& s)
+  {
+    Obj list = NEW_PLIST(T_PLIST_DENSE, 3);
+    SET_LEN_PLIST(list, 3);
+    SET_ELM_PLIST(list, 1, GAP_make(s.stack));
+    CHANGED_BAG(list);
+    SET_ELM_PLIST(list, 2, INTOBJ_INT(s.runtime));
+    SET_ELM_PLIST(list, 3, INTOBJ_INT(s.calls));
+    return list;
+  }
+};
+}
+
+void dumpRuntimes_in(StackTrace* st,
+                     const FunctionTable& functions,
+                     std::vector<StackRuntime>& ret,
+                     std::vector<FullFunction>& stack)
+{
+    ret.push_back(StackRuntime(stack, st->runtime, st->calls));
+    std::vector<std::pair<Int, StackTrace*> > children = sortedChildren(st, functions);
+    for(size_t i = 0; i < children.size(); ++i)
+    {
+        stack.push_back(functions[children[i].first]);
+        dumpRuntimes_in(children[i].second, functions, ret, stack);
         stack.pop_back();
     }
 }
 
-std::vector<std::pair<std::vector<FullFunction>, Int > > dumpRuntimes(StackTrace* st)
+std::vector<StackRuntime> dumpRuntimes(StackTrace* st, const FunctionTable& functions)
 {
-    std::vector<std::pair<std::vector<FullFunction>, Int > > ret;
+    std::vector<StackRuntime> ret;
     std::vector<FullFunction> stack;
-    dumpRuntimes_in(st, ret, stack);
+    dumpRuntimes_in(st, functions, ret, stack);
+    return ret;
+}
+
+// Rebuilds a call tree from the 'stack_runtimes' component of a profile,
+// adding each function to 'functions'. If 'squash' is true, then functions
+// which directly call themselves are merged with their caller. Entries
+// from older profiles may not have a number of calls, which is then 0.
+void readStackRuntimes(Obj stack_runtimes, FunctionTable& functions,
+                       StackTrace& root, bool squash)
+{
+    if(!IS_SMALL_LIST(stack_runtimes))
+        throw GAPException("stack_runtimes must be a list");
+    root.setupChildren();
+    Int len = LEN_LIST(stack_runtimes);
+    for(Int i = 1; i <= len; ++i)
+    {
+        Obj entry = ELM_LIST(stack_runtimes, i);
+        if(!IS_SMALL_LIST(entry) || LEN_LIST(entry) < 2)
+            throw GAPException("Invalid entry in stack_runtimes");
+        Obj path = ELM_LIST(entry, 1);
+        if(!IS_SMALL_LIST(path))
+            throw GAPException("Invalid entry in stack_runtimes");
+
+        StackTrace* st = &root;
+        Int prev = -1;
+        Int depth = LEN_LIST(path);
+        for(Int j = 1; j <= depth; ++j)
+        {
+            Int id = functions.intern(GAP_get<FullFunction>(ELM_LIST(path, j)));
+            if(squash && id == prev)
+                continue;
+            prev = id;
+            st = &(st->children->insert(std::make_pair(id, StackTrace(st))).first->second);
+            st->setupChildren();
+        }
+        st->runtime += GAP_get<Int>(ELM_LIST(entry, 2));
+        if(LEN_LIST(entry) >= 3)
+            st->calls += GAP_get<Int>(ELM_LIST(entry, 3));
+    }
+}
+
+// The 'weight' of part of a call tree, used to decide which parts are
+// cold enough to throw away. We compare ticks first, then calls, so
+// coverage profiles (which have no ticks) can still be pruned sensibly.
+typedef std::pair<Int, Int> TreeWeight;
+
+// Stores the weight of every subtree of 'st', and the number of nodes in
+// the subtree, in the order the nodes are visited.
+TreeWeight weighStackTrace(StackTrace* st, std::vector<TreeWeight>& weights,
+                           std::vector<Int>& sizes)
+{
+    size_t index = weights.size();
+    weights.push_back(TreeWeight());
+    sizes.push_back(0);
+    TreeWeight w(st->runtime, st->calls);
+    if(st->children)
+    {
+        for(std::map<Int, StackTrace>::iterator it = st->children->begin();
+            it != st->children->end();
+            ++it)
+        {
+            TreeWeight child = weighStackTrace(&(it->second), weights, sizes);
+            w.first += child.first;
+            w.second += child.second;
+        }
+    }
+    weights[index] = w;
+    sizes[index] = weights.size() - index;
+    return w;
+}
+
+// Replaces every child subtree of 'st' whose weight is at most 'threshold'
+// with a single '[other]' child (with id 'other_id'), which gets the total
+// runtime of the removed subtrees. Subtrees containing a node in 'active'
+// (the functions which are currently executing) are never removed.
+// 'index' must be the position of 'st' in the output of weighStackTrace,
+// and 'nodes' is reduced by the number of nodes removed.
+void foldStackTrace(StackTrace* st, Int& index, Int other_id, TreeWeight threshold,
+                    const std::vector<TreeWeight>& weights, const std::vector<Int>& sizes,
+                    const std::set<StackTrace*>& active, Int& nodes)
+{
+    index++;
+    if(!st->children)
+        return;
+
+    // pairs of [function id, index] of the children to remove
+    std::vector<std::pair<Int, Int> > folded;
+    for(std::map<Int, StackTrace>::iterator it = st->children->begin();
+        it != st->children->end();
+        ++it)
+    {
+        if(it->first != other_id && weights[index] <= threshold &&
+           active.count(&(it->second)) == 0)
+        {
+            folded.push_back(std::make_pair(it->first, index));
+            index += sizes[index];
+        }
+        else
+            foldStackTrace(&(it->second), index, other_id, threshold,
+                           weights, sizes, active, nodes);
+    }
+
+    if(folded.empty())
+        return;
+
+    std::map<Int, StackTrace>::iterator other = st->children->find(other_id);
+    if(other == st->children->end())
+    {
+        other = st->children->insert(std::make_pair(other_id, StackTrace(st))).first;
+        nodes++;
+    }
+
+    for(size_t i = 0; i < folded.size(); ++i)
+    {
+        std::map<Int, StackTrace>::iterator child = st->children->find(folded[i].first);
+        other->second.runtime += weights[folded[i].second].first;
+        other->second.calls += child->second.calls;
+        nodes -= sizes[folded[i].second];
+        st->children->erase(child);
+    }
+}
+
+// Shrinks the call tree 'root', which contains 'nodes' nodes, so it contains
+// at most 'target' nodes if possible, by throwing away the coldest subtrees.
+// This is a form of lossy counting: a call path is only forgotten while its
+// weight is below the threshold we return, so any call path heavier than the
+// largest threshold ever used is still reported exactly.
+TreeWeight pruneStackTrace(StackTrace* root, StackTrace* current, Int other_id,
+                           Int target, Int& nodes)
+{
+    std::set<StackTrace*> active;
+    for(StackTrace* st = current; st; st = st->parent)
+        active.insert(st);
+
+    std::vector<TreeWeight> weights;
+    std::vector<Int> sizes;
+    weighStackTrace(root, weights, sizes);
+
+    // The weight of a subtree is never less than the weight of a subtree
+    // inside it, so removing all subtrees of weight at most the k'th smallest
+    // weight removes (at least) k nodes.
+    std::vector<TreeWeight> sorted(weights.begin() + 1, weights.end());
+    Int remove = nodes - target;
+    if(remove <= 0 || sorted.empty())
+        return TreeWeight(0, 0);
+    if(remove > (Int)sorted.size())
+        remove = sorted.size();
+    std::nth_element(sorted.begin(), sorted.begin() + (remove - 1), sorted.end());
+    TreeWeight threshold = sorted[remove - 1];
+
+    Int index = 0;
+    foldStackTrace(root, index, other_id, threshold, weights, sizes, active, nodes);
+    return threshold;
+}
+
+// Options which can be passed to READ_PROFILE_FROM_STREAM in a record.
+// Anything which is not a record is treated as an empty record.
+struct ReaderOptions
+{
+  // Width of a timeline bucket, in ticks (0 disables the timeline)
+  Int timeline_ticks;
+  // Set if the width was given in seconds, so ticks must be microseconds
+  bool timeline_seconds;
+  // Maximum number of nodes in the call tree (0 for no limit)
+  Int max_tree_nodes;
+  // Merge functions which directly call themselves in the call tree
+  bool squash;
+  // File to write a trace of function calls to ("" for none)
+  std::string trace_file;
+  // Calls shorter than this are left out of the trace
+  Int trace_min_ticks;
+  // Also build a call tree which records the line each function was called from
+  bool line_stacks;
+  // Time reading, parsing and aggregating each line separately
+  bool phase_timing;
+
+  ReaderOptions() : timeline_ticks(0), timeline_seconds(false), max_tree_nodes(0),
+                    squash(false), trace_min_ticks(0), line_stacks(false),
+                    phase_timing(false)
+  { }
+};
+
+ReaderOptions readReaderOptions(Obj opts)
+{
+  ReaderOptions ro;
+  if(!IS_REC(opts))
+    return ro;
+
+  GAPRecord r(opts);
+  if(r.has("timeline_ticks"))
+  {
+    Obj o = r.get("timeline_ticks");
+    if(!IS_INTOBJ(o) || INT_INTOBJ(o) <= 0)
+      throw GAPException("timeline_ticks must be a positive integer");
+    ro.timeline_ticks = INT_INTOBJ(o);
+  }
+  if(r.has("timeline_seconds"))
+  {
+    Obj o = r.get("timeline_seconds");
+    if(!IS_INTOBJ(o) || INT_INTOBJ(o) <= 0)
+      throw GAPException("timeline_seconds must be a positive integer");
+    // GAP records time in microseconds. Profiles which record memory
+    // are rejected once we read their time type.
+    ro.timeline_ticks = INT_INTOBJ(o) * 1000000;
+    ro.timeline_seconds = true;
+  }
+  if(r.has("max_tree_nodes"))
+  {
+    Obj o = r.get("max_tree_nodes");
+    if(!IS_INTOBJ(o) || INT_INTOBJ(o) <= 0)
+      throw GAPException("max_tree_nodes must be a positive integer");
+    ro.max_tree_nodes = INT_INTOBJ(o);
+  }
+  ro.squash = GAP_get_maybe_bool_rec(opts, RNamName("squash"));
+  ro.line_stacks = GAP_get_maybe_bool_rec(opts, RNamName("line_stacks"));
+  ro.phase_timing = GAP_get_maybe_bool_rec(opts, RNamName("phase_timing"));
+  if(r.has("trace_file"))
+  {
+    Obj o = r.get("trace_file");
+    if(!IS_STRING(o))
+      throw GAPException("trace_file must be a string");
+    ro.trace_file = GAP_get<std::string>(CopyToStringRep(o));
+    // A trace of every call would be far too large to look at
+    if(!r.has("trace_min_ticks"))
+      throw GAPException("trace_min_ticks must be given with trace_file");
+    o = r.get("trace_min_ticks");
+    if(!IS_INTOBJ(o) || INT_INTOBJ(o) <= 0)
+      throw GAPException("trace_min_ticks must be a positive integer");
+    ro.trace_min_ticks = INT_INTOBJ(o);
+  }
+  return ro;
+}
+
+// A second call tree, in which each node is a function together with the
+// line it was called from, so calls to the same function from different
+// lines of one caller (for example, from two loops) can be told apart.
+// Each node is stored as a function whose name also gives the calling line,
+// so the tree can be drawn like any other. The ticks of each node are also
+// split by the line which was running, which gives the line running in
+// every frame of each sample, for pprof.
+typedef std::pair<std::vector<std::pair<FullFunction, Int> >, Int> LineSample;
+
+struct LineCallTree
+{
+  FunctionTable frames;
+  // The function, and the line it was called from, of each frame
+  std::vector<std::pair<FullFunction, Int> > sites;
+  StackTrace root;
+  StackTrace* current;
+  std::vector<StackTrace*> node_stack;
+  Int nodes;
+  // This tree is pruned just like the main call tree
+  Int max_nodes;
+  Int prune_at;
+
+  LineCallTree(Int _max_nodes)
+    : current(&root), nodes(0), max_nodes(_max_nodes), prune_at(_max_nodes)
+  { root.setupChildren(); }
+
+  static FullFunction frame(const FullFunction& f, const std::string& call_file, Int call_line)
+  {
+    if(call_file.empty())
+      return f;
+    std::string::size_type slash = call_file.rfind('/');
+    std::ostringstream name;
+    name << f.name << " [from "
+         << (slash == std::string::npos ? call_file : call_file.substr(slash + 1))
+         << ":" << call_line << "]";
+    return FullFunction(name.str(), f.filename, f.line, f.endline);
+  }
+
+  Int frameId(const FullFunction& f, const std::string& call_file, Int call_line)
+  {
+    Int id = frames.intern(frame(f, call_file, call_line));
+    if(id == (Int)sites.size())
+      sites.push_back(std::make_pair(f, call_file.empty() ? 0 : call_line));
+    return id;
+  }
+
+  // Enter 'f', called from 'call_line' of 'call_file'. If 'recursive' is
+  // true, we stay in the current node.
+  void enter(const FullFunction& f, const std::string& call_file, Int call_line, bool recursive)
+  {
+    node_stack.push_back(current);
+    if(!recursive)
+    {
+      Int id = frameId(f, call_file, call_line);
+      std::pair<std::map<Int, StackTrace>::iterator, bool> next =
+        current->children->insert(std::make_pair(id, StackTrace(current)));
+      current = &(next.first->second);
+      current->setupChildren();
+      if(next.second)
+      {
+        nodes++;
+        if(prune_at > 0 && nodes > prune_at)
+        {
+          pruneStackTrace(&root, current, frameId(otherFunction(), "", 0), max_nodes / 2, nodes);
+          prune_at = std::max(max_nodes, nodes + max_nodes / 2 + 1);
+        }
+      }
+    }
+    current->calls++;
+  }
+
+  void leave()
+  {
+    if(node_stack.empty())
+      return;
+    current = node_stack.back();
+    node_stack.pop_back();
+  }
+
+  // Charge 'ticks' to line 'line' of the function running now
+  void addTicks(Int line, Int ticks)
+  {
+    current->runtime += ticks;
+    if(!current->line_runtimes)
+      current->line_runtimes = new std::map<Int, Int>;
+    (*current->line_runtimes)[line] += ticks;
+  }
+
+  // A sample for each line which ran in each node below 'st', whose path
+  // from the root is 'path'. Each sample gives the function and line running
+  // in each frame, from the outermost in, and the ticks spent there. Ticks
+  // which were pruned into '[other]' have no line, and are given the first
+  // line of their function.
+  void dumpSamples(StackTrace* st, std::vector<Int>& path, std::vector<LineSample>& ret) const
+  {
+    if(path.empty())
+    {
+      // There is no function to give the lines at the top level
+      if(st->runtime > 0)
+        ret.push_back(LineSample(std::vector<std::pair<FullFunction, Int> >(), st->runtime));
+    }
+    else
+    {
+      std::vector<std::pair<FullFunction, Int> > locations;
+      for(size_t i = 0; i + 1 < path.size(); ++i)
+        locations.push_back(std::make_pair(sites[path[i]].first, sites[path[i + 1]].second));
+      const FullFunction& f = sites[path.back()].first;
+      locations.push_back(std::make_pair(f, f.line));
+      Int unknown = st->runtime;
+      if(st->line_runtimes)
+      {
+        for(std::map<Int, Int>::const_iterator it = st->line_runtimes->begin();
+            it != st->line_runtimes->end(); ++it)
+        {
+          locations.back().second = it->first;
+          ret.push_back(LineSample(locations, it->second));
+          unknown -= it->second;
+        }
+      }
+      if(unknown > 0)
+      {
+        locations.back().second = f.line;
+        ret.push_back(LineSample(locations, unknown));
+      }
+    }
+
+    if(!st->children)
+      return;
+    for(std::map<Int, StackTrace>::iterator it = st->children->begin();
+        it != st->children->end(); ++it)
+    {
+      path.push_back(it->first);
+      dumpSamples(&(it->second), path, ret);
+      path.pop_back();
+    }
+  }
+
+  std::vector<LineSample> samples()
+  {
+    std::vector<LineSample> ret;
+    std::vector<Int> path;
+    dumpSamples(&root, path, ret);
     return ret;
+  }
+};
+
+// Splits the ticks spent in each function, and each file, into buckets
+// which are each 'bucket_ticks' long, so we can see how the behaviour of
+// a program changes over time.
+struct Timeline
+{
+  Int bucket_ticks;
+  Int buckets;
+  std::map<FullFunction, std::vector<Int> > function_ticks;
+  std::map<Int, std::vector<Int> > file_ticks;
+
+  Timeline(Int _bucket_ticks) : bucket_ticks(_bucket_ticks), buckets(0)
+  { }
+
+  // Charge 'ticks' ticks, which started at time 'start', to 'row'.
+  // Ticks which cross a bucket boundary are split between buckets.
+  void addTicks(std::vector<Int>& row, long long start, Int ticks)
+  {
+    while(ticks > 0)
+    {
+      Int bucket = start / bucket_ticks;
+      Int used = std::min<long long>(ticks, (bucket + 1) * (long long)bucket_ticks - start);
+      if((Int)row.size() <= bucket)
+        row.resize(bucket + 1, 0);
+      row[bucket] += used;
+      buckets = std::max(buckets, bucket + 1);
+      start += used;
+      ticks -= used;
+    }
+  }
+
+  void add(const std::vector<FullFunction>& function_stack, Int fileid,
+           long long start, Int ticks)
+  {
+    // Time spent outside of any function only counts towards files
+    if(!function_stack.empty())
+      addTicks(function_ticks[function_stack.back()], start, ticks);
+    addTicks(file_ticks[fileid], start, ticks);
+  }
+
+  // Returns the timeline as a record of matrices, with one row for each
+  // function (or file), and one column for each bucket.
+  GAPRecord toGAP(const std::map<Int, std::string>& filename_map)
+  {
+    std::vector<FullFunction> functions;
+    std::vector<std::vector<Int> > function_rows;
+    for(std::map<FullFunction, std::vector<Int> >::iterator it = function_ticks.begin();
+        it != function_ticks.end(); ++it)
+    {
+      functions.push_back(it->first);
+      it->second.resize(buckets, 0);
+      function_rows.push_back(it->second);
+    }
+
+    std::vector<std::string> files;
+    std::vector<std::vector<Int> > file_rows;
+    for(std::map<Int, std::vector<Int> >::iterator it = file_ticks.begin();
+        it != file_ticks.end(); ++it)
+    {
+      std::map<Int, std::string>::const_iterator name = filename_map.find(it->first);
+      if(name == filename_map.end())
+        continue;
+      files.push_back(name->second);
+      it->second.resize(buckets, 0);
+      file_rows.push_back(it->second);
+    }
+
+    GAPRecord r;
+    r.set("bucket_ticks", bucket_ticks);
+    r.set("buckets", buckets);
+    r.set("functions", functions);
+    r.set("function_ticks", function_rows);
+    r.set("files", files);
+    r.set("file_ticks", file_rows);
+    return r;
+  }
+};
+
+// Nanoseconds since some fixed point, used to time the phases of reading
+// a profile. This clock never goes backwards.
+static Int monotonicNanoseconds()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (Int)ts.tv_sec * 1000000000 + (Int)ts.tv_nsec;
 }
 
+// Statistics about the reader itself, to help find out why reading
+// a profile is slow.
+struct ReaderStats
+{
+  // Number of records of each ProfType, indexed by ProfType
+  Int records[Info + 1];
+  Int lines;
+  Int bytes_read;
+  Int damaged_lines;
+  Int max_stack_depth;
+
+  // Size of the call tree, and how much of it was thrown away to stay
+  // within ReaderOptions::max_tree_nodes
+  Int tree_nodes;
+  Int peak_tree_nodes;
+  Int pruned_nodes;
+  Int prune_threshold;
+  // Number of events written to ReaderOptions::trace_file
+  Int trace_events;
+
+  // Nanoseconds spent in each phase of reading. 'loop' is the whole pass
+  // over the file, 'build' is gathering the results and 'convert' is making
+  // GAP objects. Only with ReaderOptions::phase_timing is the loop split
+  // into 'read', which includes waiting for gzip to decompress the file,
+  // 'parse', which is parsing JSON, and 'aggregate', which is updating our
+  // data structures with each record, as this costs three clock reads for
+  // every line.
+  Int loop_ns;
+  Int read_ns;
+  Int parse_ns;
+  Int aggregate_ns;
+  Int build_ns;
+  Int convert_ns;
+
+  ReaderStats() : lines(0), bytes_read(0), damaged_lines(0), max_stack_depth(0),
+    tree_nodes(0), peak_tree_nodes(0), pruned_nodes(0), prune_threshold(0),
+    trace_events(0), loop_ns(0), read_ns(0), parse_ns(0), aggregate_ns(0), build_ns(0), convert_ns(0)
+  {
+    for(int i = 0; i <= Info; ++i)
+      records[i] = 0;
+  }
+
+  GAPRecord toGAP() const
+  {
+    GAPRecord r;
+    r.set("read_records", records[Read]);
+    r.set("exec_records", records[Exec]);
+    r.set("into_fun_records", records[IntoFun]);
+    r.set("out_fun_records", records[OutFun]);
+    r.set("string_id_records", records[StringId]);
+    r.set("info_records", records[Info]);
+    r.set("lines", lines);
+    r.set("bytes_read", bytes_read);
+    r.set("damaged_lines", damaged_lines);
+    r.set("max_stack_depth", max_stack_depth);
+    r.set("tree_nodes", tree_nodes);
+    r.set("peak_tree_nodes", peak_tree_nodes);
+    r.set("pruned_nodes", pruned_nodes);
+    r.set("prune_threshold", prune_threshold);
+    r.set("trace_events", trace_events);
+    r.set("loop_ns", loop_ns);
+    r.set("read_ns", read_ns);
+    r.set("parse_ns", parse_ns);
+    r.set("aggregate_ns", aggregate_ns);
+    r.set("build_ns", build_ns);
+    r.set("convert_ns", convert_ns);
+    return r;
+  }
+};
+
 struct TimeStash
 {
   Int runtime;
@@ -213,7 +854,106 @@ struct TimeStash
   total_ticks(_tt) { }
 };
 
-static int endsWithgz(char* s)
+// Counts for an edge of the call graph, or a call site.
+// 'active' is how many calls along this edge are currently running,
+// so recursive calls do not have their time counted more than once.
+struct CallStats
+{
+  Int calls;
+  Int ticks;
+  Int self_ticks;
+  Int active;
+
+  CallStats() : calls(0), ticks(0), self_ticks(0), active(0) { }
+
+  void enter()
+  {
+    calls++;
+    active++;
+  }
+
+  void leave(Int duration)
+  {
+    active--;
+    if(active == 0)
+      ticks += duration;
+  }
+};
+
+// A histogram of how long each call to a function took, in the style of
+// HdrHistogram. Durations below 32 ticks are counted exactly. Larger
+// durations are put in one of 16 buckets for each power of two, so a
+// duration is known to within about 6%, and the histogram stays small
+// however long calls take.
+struct DurationHistogram
+{
+  std::vector<Int> counts;
+  Int calls;
+  Int max;
+
+  DurationHistogram() : calls(0), max(0) { }
+
+  static Int bucketOf(Int ticks)
+  {
+    if(ticks < 32)
+      return ticks;
+    Int shift = 0;
+    while((ticks >> shift) >= 32)
+      shift++;
+    return (shift + 1) * 16 + (ticks >> shift) - 16;
+  }
+
+  // The largest duration which is put in 'bucket'
+  static Int bucketMax(Int bucket)
+  {
+    if(bucket < 32)
+      return bucket;
+    Int shift = bucket / 16 - 1;
+    return (((bucket % 16) + 17) << shift) - 1;
+  }
+
+  void add(Int ticks)
+  {
+    if(ticks < 0)
+      ticks = 0;
+    Int bucket = bucketOf(ticks);
+    if((Int)counts.size() <= bucket)
+      counts.resize(bucket + 1, 0);
+    counts[bucket]++;
+    calls++;
+    max = std::max(max, ticks);
+  }
+
+  // The smallest duration which at least 'percent'% of calls were no longer than
+  Int percentile(Int percent) const
+  {
+    if(calls == 0)
+      return 0;
+    Int needed = (calls * percent + 99) / 100;
+    Int seen = 0;
+    for(size_t i = 0; i < counts.size(); ++i)
+    {
+      seen += counts[i];
+      if(seen >= needed)
+        return std::min(bucketMax(i), max);
+    }
+    return max;
+  }
+
+  // [calls, p50, p90, p99, max]
+  std::vector<Int> summary() const
+  {
+    std::vector<Int> ret;
+    ret.push_back(calls);
+    ret.push_back(percentile(50));
+    ret.push_back(percentile(90));
+    ret.push_back(percentile(99));
+    ret.push_back(max);
+    return ret;
+  }
+};
+
+static int endsWithgz(const char* s)
 {
   s = strrchr(s, '.');
   if(s)
@@ -252,11 +992,79 @@ struct Stream {
     }
 };
 
+// Quote 's' so it can be passed to the shell
+static std::string shellQuote(const std::string& s)
+{
+  std::string ret = "'";
+  for(size_t i = 0; i < s.size(); ++i)
+  {
+    if(s[i] == '\'')
+      ret += "'\\''";
+    else
+      ret += s[i];
+  }
+  ret += "'";
+  return ret;
+}
+
+// Writes to a file, compressing it with gzip if asked
+struct OutStream {
+  FILE* stream;
+  bool wasPopened;
+
+  OutStream() : stream(0), wasPopened(false) { }
+
+  OutStream(const char* name, bool gzip) : stream(0), wasPopened(false) {
+    if(!name)
+      return;
+    // Check we can create the file first, as if the shell cannot then
+    // writing to 'gzip' would raise SIGPIPE
+    stream = fopen(name, "w");
+    if(stream && gzip)
+    {
+      fclose(stream);
+      std::string command = "gzip -c > " + shellQuote(name);
+      stream = popen(command.c_str(), "w");
+      wasPopened = true;
+    }
+  }
+
+  bool fail()
+  { return stream == 0; }
 
+  // Returns false if anything could not be written
+  bool close() {
+    if(!stream)
+      return false;
+    int ret = wasPopened ? pclose(stream) : fclose(stream);
+    stream = 0;
+    return ret == 0;
+  }
+
+  ~OutStream() {
+      if(stream)
+        close();
+    }
+};
+
+#include "callgrind.h"
+#include "chrome_trace.h"
+#include "profile_ticks.h"
+#include "profile_diff.h"
+#include "profile_stats.h"
+#include "profile_budget.h"
+#include "pprof.h"
+#include "flamegraph.h"
+#include "html_encode.h"
+#include "work_queue.h"
+#include "source_cache.h"
+#include "coverage_html.h"
+#include "coverage_export.h"
 
 Obj FuncREAD_PROFILE_FROM_STREAM(Obj self, Obj filename, Obj param2)
 {
 try{
+    ReaderOptions options = readReaderOptions(param2);
     bool isCover = false;
     std::string timeType;
     int failedparse = 0;
@@ -270,11 +1078,20 @@ try{
     std::map<Int, std::map<Int, Int> > runtime_lines;
     std::map<Int, std::map<Int, Int> > runtime_with_children_lines;
 
-    std::map<Int, std::map<Int, std::set<FullFunction> > > called_functions;
+    std::map<Int, std::map<Int, std::map<FullFunction, CallStats> > > called_functions;
     std::map<Int, std::map<Int, std::set<Location> > > calling_functions;
+    FunctionTable functions;
+    // How long each call took, for each function in 'functions'
+    std::vector<DurationHistogram> durations;
+    // Edges of the call graph, from (caller, callee). The caller is -1 for
+    // functions called from the top level.
+    std::map<std::pair<Int, Int>, CallStats> call_graph;
     StackTrace stacktrace;
     stacktrace.setupChildren();
     StackTrace* current_stack = &stacktrace;
+    // When the call tree grows past 'prune_at' nodes, we prune it
+    Int prune_at = options.max_tree_nodes;
+    LineCallTree line_tree(options.max_tree_nodes);
 
     // prev_exec is the last function executed, calling_exec is the statement which
     // we would currently say called a function. The only time when there differ
@@ -284,6 +1101,11 @@ try{
 
     // These keeps track of us going down our function stack
     std::vector<FullFunction> function_stack;
+    std::vector<Int> funcid_stack;
+    // The node of the call tree to return to when each function ends
+    std::vector<StackTrace*> node_stack;
+    // The call graph edge and call site of each running function
+    std::vector<std::pair<CallStats*, CallStats*> > call_stack;
     std::vector<JsonParse> line_stack;
     // this stores various time values
     // when we call a function, so we can correct everything on return.
@@ -291,6 +1113,10 @@ try{
 
     long long total_ticks = 0;
 
+    ReaderStats stats;
+
+    Timeline timeline(options.timeline_ticks);
+
     if(!(IS_STRING(filename))) {
       ErrorMayQuit("Filename must be a string", 0, 0);
     }
@@ -301,8 +1127,20 @@ try{
       return Fail;
     }
 
+    const char* trace_name = options.trace_file.empty() ? 0 : options.trace_file.c_str();
+    OutStream trace_stream(trace_name, trace_name && endsWithgz(trace_name));
+    if(trace_name && trace_stream.fail()) {
+      ErrorMayQuit("Unable to open file %s", (Int)trace_name, 0);
+      return Fail;
+    }
+    ChromeTrace trace(trace_stream.stream, options.trace_min_ticks);
+
     long line_number = 0;
 
+    const bool phase_timing = options.phase_timing;
+    Int loop_start = monotonicNanoseconds();
+    Int phase_start = loop_start;
+    Int parse_end = loop_start;
     while(true)
     {
       if(feof(infile.stream)) {
@@ -319,9 +1157,27 @@ try{
           return Fail;
         }
       }
+      stats.lines++;
+      stats.bytes_read += strlen(str);
+      Int read_end = 0;
+      if(phase_timing)
+      {
+        read_end = monotonicNanoseconds();
+        stats.read_ns += read_end - phase_start;
+      }
+
       JsonParse ret;
-      if(ReadJson(str, ret))
+      bool parsed = ReadJson(str, ret);
+      if(phase_timing)
       {
+        parse_end = monotonicNanoseconds();
+        stats.parse_ns += parse_end - read_end;
+      }
+
+      if(parsed)
+      {
+        if(ret.Type != InvalidType)
+          stats.records[ret.Type]++;
         switch(ret.Type)
         {
           case InvalidType: ErrorReturnVoid("Internal Error",0,0,""); break;
@@ -337,7 +1193,7 @@ try{
           {
             FullFunction retfunc = buildFunctionName(ret);
             // Record which line called this function
-            called_functions[calling_exec.FileId][calling_exec.Line].insert(retfunc);
+            CallStats* site = &called_functions[calling_exec.FileId][calling_exec.Line][retfunc];
             // Record we called this function from here
             if(!function_stack.empty()) {
               // This '!= 0' is to support older GAP's which don't provide this field
@@ -348,10 +1204,10 @@ try{
             }
             // Add this function to the stack of executing functions
             function_stack.push_back(retfunc);
+            trace.enter(retfunc, total_ticks);
 
-            static int deepest_depth = 0;
-            if(function_stack.size() > deepest_depth) {
-              deepest_depth = function_stack.size();
+            if((Int)function_stack.size() > stats.max_stack_depth) {
+              stats.max_stack_depth = function_stack.size();
             }
             // And to stack of executed files/line numbers
             line_stack.push_back(calling_exec);
@@ -361,27 +1217,80 @@ try{
                         runtime_with_children_lines[calling_exec.FileId][calling_exec.Line],
                         total_ticks));
 
-            StackTrace* next_stack = &((*(current_stack->children))[function_stack.back()]);
-            next_stack->setupChildren();
+            Int funcid = functions.intern(retfunc);
+            if((Int)durations.size() < functions.size())
+              durations.resize(functions.size());
+            CallStats* edge =
+              &call_graph[std::make_pair(funcid_stack.empty() ? -1 : funcid_stack.back(), funcid)];
+            edge->enter();
+            site->enter();
+            call_stack.push_back(std::make_pair(edge, site));
+            node_stack.push_back(current_stack);
+            // When squashing, a function which calls itself stays in the
+            // same node of the call tree
+            bool recursive = options.squash && !funcid_stack.empty() &&
+                             funcid_stack.back() == funcid;
+            funcid_stack.push_back(funcid);
+            if(options.line_stacks)
+            {
+              std::map<Int, std::string>::const_iterator call_file = filename_map.find(calling_exec.FileId);
+              line_tree.enter(retfunc, call_file == filename_map.end() ? "" : call_file->second,
+                              calling_exec.Line, recursive);
+            }
 
-            if(!next_stack->parent)
-                next_stack->parent = current_stack;
-            assert(next_stack->parent == current_stack);
-            current_stack = next_stack;
+            std::pair<std::map<Int, StackTrace>::iterator, bool> next(current_stack->children->end(), false);
+            if(!recursive)
+            {
+              next = current_stack->children->insert(std::make_pair(funcid, StackTrace(current_stack)));
+              StackTrace* next_stack = &(next.first->second);
+              next_stack->setupChildren();
+              assert(next_stack->parent == current_stack);
+              current_stack = next_stack;
+            }
             (current_stack->calls)++;
+
+            if(next.second)
+            {
+              stats.tree_nodes++;
+              stats.peak_tree_nodes = std::max(stats.peak_tree_nodes, stats.tree_nodes);
+              if(prune_at > 0 && stats.tree_nodes > prune_at)
+              {
+                // Prune down to half our budget, so we do not have to prune
+                // again for a while
+                Int before = stats.tree_nodes;
+                TreeWeight threshold =
+                  pruneStackTrace(&stacktrace, current_stack, functions.intern(otherFunction()),
+                                  options.max_tree_nodes / 2, stats.tree_nodes);
+                stats.pruned_nodes += before - stats.tree_nodes;
+                stats.prune_threshold = std::max(stats.prune_threshold, threshold.first);
+                // If we could not prune enough (because the stack of running
+                // functions is too deep), do not try again immediately
+                prune_at = std::max(options.max_tree_nodes,
+                                    stats.tree_nodes + options.max_tree_nodes / 2 + 1);
+              }
+            }
           }
           break;
           case OutFun:
           {
-            if(current_stack->parent)
+            if(!node_stack.empty())
             {
-                current_stack = current_stack->parent;
+                current_stack = node_stack.back();
                 calling_exec = line_stack.back();
                 TimeStash ts = line_times_stack.back();
                 runtime_with_children_lines[calling_exec.FileId][calling_exec.Line] =
                   ts.runtime_with_children + (total_ticks - ts.total_ticks) -
                     (runtime_lines[calling_exec.FileId][calling_exec.Line] - ts.runtime);
+                call_stack.back().first->leave(total_ticks - ts.total_ticks);
+                call_stack.back().second->leave(total_ticks - ts.total_ticks);
+                trace.leave(total_ticks);
+                durations[funcid_stack.back()].add(total_ticks - ts.total_ticks);
                 function_stack.pop_back();
+                funcid_stack.pop_back();
+                call_stack.pop_back();
+                node_stack.pop_back();
+                if(options.line_stacks)
+                  line_tree.leave();
                 line_stack.pop_back();
                 line_times_stack.pop_back();
             }
@@ -408,7 +1317,14 @@ try{
                 // Hard to know exactly where to charge these to --
                 // this is easiest
                 (current_stack->runtime) += ret.Ticks;
+                if(options.line_stacks)
+                  line_tree.addTicks(prev_exec.Line, ret.Ticks);
+                if(!call_stack.empty())
+                  call_stack.back().first->self_ticks += ret.Ticks;
+                if(options.timeline_ticks > 0)
+                  timeline.add(function_stack, prev_exec.FileId, total_ticks, ret.Ticks);
                 total_ticks += ret.Ticks;
+                trace.advance(total_ticks);
               }
             }
           }
@@ -416,6 +1332,8 @@ try{
           case Info:
             isCover = ret.IsCover;
             timeType = ret.TimeType;
+            if(options.timeline_seconds && timeType == "Memory")
+              throw GAPException("timeline_seconds can not be used with a profile of memory use");
           break;
         }
       }
@@ -423,6 +1341,7 @@ try{
       {
         // We allow a few failed parses to deal with truncated files
         failedparse++;
+        stats.damaged_lines++;
         Pr("Warning: damaged profile at %g:%d",  (Int)filenamestr, (Int)line_number);
         if(failedparse > 4) {
           throw GAPException("Malformed profile");
@@ -432,16 +1351,42 @@ try{
 
       if(ret.Type == Exec) { prev_exec = ret; calling_exec = ret; }
       if(ret.Type == Info) { calling_exec = ret; }
+
+      if(phase_timing)
+      {
+        phase_start = monotonicNanoseconds();
+        stats.aggregate_ns += phase_start - parse_end;
+      }
     }
+    Int loop_end = monotonicNanoseconds();
+    stats.loop_ns = loop_end - loop_start;
 
 
+    trace.finish(total_ticks);
+    stats.trace_events = trace.events;
+    if(trace_name && !trace_stream.close())
+      throw GAPException("Unable to write trace_file");
+
+    // Functions which were still running when the profile ended finish now
+    while(!call_stack.empty())
+    {
+      call_stack.back().first->leave(total_ticks - line_times_stack.back().total_ticks);
+      call_stack.back().second->leave(total_ticks - line_times_stack.back().total_ticks);
+      durations[funcid_stack.back()].add(total_ticks - line_times_stack.back().total_ticks);
+      call_stack.pop_back();
+      funcid_stack.pop_back();
+      line_times_stack.pop_back();
+    }
+
     // Now lets build a bunch of stuff which GAP will want back.
     // This stores the read, exec and runtime data.
     // vector of [filename, [ [read,exec,runtime] of line 1, [read,exec,runtime] of line 2, ... ] ]
 
     std::vector<std::pair<std::string, std::vector<std::vector<Int> > > > read_exec_data;
 
-    std::vector<std::pair<std::string, std::vector<std::set<FullFunction> > > > called_functions_ret;
+    std::vector<std::pair<std::string, std::vector<std::vector<FullFunction> > > > called_functions_ret;
+    // [calls, ticks] for each function in called_functions_ret
+    std::vector<std::pair<std::string, std::vector<std::vector<std::vector<Int> > > > > called_stats_ret;
     std::vector<std::pair<std::string, std::vector<std::set<Location> > > > calling_functions_ret;
 
     // First gather all used filenames
@@ -466,7 +1411,7 @@ try{
       std::map<Int,Int>& exec_set = exec_lines[*it];
       std::map<Int,Int>& runtime = runtime_lines[*it];
       std::map<Int,Int>& runtime_children = runtime_with_children_lines[*it];
-      std::map<Int, std::set<FullFunction> >& functions = called_functions[*it];
+      std::map<Int, std::map<FullFunction, CallStats> >& functions = called_functions[*it];
       std::map<Int, std::set<Location> >& functions_calling = calling_functions[*it];
 
       Int max_line = 0;
@@ -489,7 +1434,8 @@ try{
         max_line = std::max(max_line, functions_calling.rbegin()->first);
 
       std::vector<std::vector<Int> > line_data;
-      std::vector<std::set<FullFunction> > called_data;
+      std::vector<std::vector<FullFunction> > called_data;
+      std::vector<std::vector<std::vector<Int> > > called_stats;
       std::vector<std::set<Location> > calling_data;
       for(int i = 1; i <= max_line; ++i)
       {
@@ -500,7 +1446,19 @@ try{
         data.push_back(runtime_children[i]);
         line_data.push_back(data);
 
-        called_data.push_back(functions[i]);
+        std::vector<FullFunction> called;
+        std::vector<std::vector<Int> > stats;
+        std::map<FullFunction, CallStats>& called_map = functions[i];
+        for(std::map<FullFunction, CallStats>::iterator f = called_map.begin(); f != called_map.end(); ++f)
+        {
+          called.push_back(f->first);
+          std::vector<Int> call_stats;
+          call_stats.push_back(f->second.calls);
+          call_stats.push_back(f->second.ticks);
+          stats.push_back(call_stats);
+        }
+        called_data.push_back(called);
+        called_stats.push_back(stats);
         calling_data.push_back(functions_calling[i]);
       }
 
@@ -512,11 +1470,38 @@ try{
       {
         read_exec_data.push_back(std::make_pair(filename_map[*it], line_data));
         called_functions_ret.push_back(std::make_pair(filename_map[*it], called_data));
+        called_stats_ret.push_back(std::make_pair(filename_map[*it], called_stats));
         calling_functions_ret.push_back(std::make_pair(filename_map[*it], calling_data));
       }
     }
 
-    std::vector<std::pair<std::vector<FullFunction>, Int> > function_stack_runtimes = dumpRuntimes(&stacktrace);
+    std::vector<StackRuntime> function_stack_runtimes = dumpRuntimes(&stacktrace, functions);
+
+    // The call graph is a list of edges [caller, callee, calls, ticks, self_ticks],
+    // where functions are positions in 'functions', and caller 0 is the top level.
+    std::vector<std::vector<Int> > call_graph_edges;
+    for(std::map<std::pair<Int, Int>, CallStats>::iterator it = call_graph.begin();
+        it != call_graph.end(); ++it)
+    {
+      std::vector<Int> edge;
+      edge.push_back(it->first.first + 1);
+      edge.push_back(it->first.second + 1);
+      edge.push_back(it->second.calls);
+      edge.push_back(it->second.ticks);
+      edge.push_back(it->second.self_ticks);
+      call_graph_edges.push_back(edge);
+    }
+    GAPRecord call_graph_rec;
+    call_graph_rec.set("edges", call_graph_edges);
+
+    // Pruning the call tree can add the '[other]' function
+    durations.resize(functions.size());
+    std::vector<std::vector<Int> > function_durations;
+    for(size_t i = 0; i < durations.size(); ++i)
+      function_durations.push_back(durations[i].summary());
+
+    Int build_end = monotonicNanoseconds();
+    stats.build_ns = build_end - loop_end;
 
     GAPRecord info;
     info.set("is_cover", isCover);
@@ -527,8 +1512,22 @@ try{
     r.set("line_info", read_exec_data);
     r.set("stack_runtimes", function_stack_runtimes);
     r.set("line_function_calls", called_functions_ret);
+    r.set("line_function_call_stats", called_stats_ret);
     r.set("line_calling_function_calls", calling_functions_ret);
+    r.set("functions", functions.functions);
+    r.set("call_graph", call_graph_rec);
+    r.set("function_durations", function_durations);
     r.set("info", info);
+    if(options.timeline_ticks > 0)
+      r.set("timeline", timeline.toGAP(filename_map));
+    if(options.line_stacks)
+    {
+      r.set("line_stack_runtimes", dumpRuntimes(&line_tree.root, line_tree.frames));
+      r.set("line_samples", line_tree.samples());
+    }
+
+    stats.convert_ns = monotonicNanoseconds() - build_end;
+    info.set("reader_stats", stats.toGAP());
 
     return GAP_make(r);
 } catch (const GAPException& exp) {
@@ -537,6 +1536,182 @@ try{
 return Fail;
 }
 
+Obj FuncSQUASH_STACK_RUNTIMES(Obj self, Obj stack_runtimes)
+{
+try {
+    FunctionTable functions;
+    StackTrace stacktrace;
+    readStackRuntimes(stack_runtimes, functions, stacktrace, true);
+    return GAP_make(dumpRuntimes(&stacktrace, functions));
+} catch (const GAPException& exp) {
+  ErrorMayQuit(exp.what(), 0, 0);
+}
+return Fail;
+}
+
+Obj FuncWRITE_FLAME_GRAPHS(Obj self, Obj stack_runtimes, Obj graphs)
+{
+try {
+    return writeFlameGraphs(stack_runtimes, graphs);
+} catch (const GAPException& exp) {
+  ErrorMayQuit(exp.what(), 0, 0);
+}
+return Fail;
+}
+
+Obj FuncWRITE_FOLDED_STACKS(Obj self, Obj stack_runtimes, Obj filename, Obj options)
+{
+try {
+    return writeFoldedStacks(stack_runtimes, filename, options);
+} catch (const GAPException& exp) {
+  ErrorMayQuit(exp.what(), 0, 0);
+}
+return Fail;
+}
+
+Obj FuncWRITE_DIFF_FLAME_GRAPH(Obj self, Obj stacks, Obj options)
+{
+try {
+    return writeDiffFlameGraph(stacks, options);
+} catch (const GAPException& exp) {
+  ErrorMayQuit(exp.what(), 0, 0);
+}
+return Fail;
+}
+
+Obj FuncWRITE_FLAME_GRAPH_DATA(Obj self, Obj stack_runtimes, Obj dir, Obj options)
+{
+try {
+    return writeFlameGraphData(stack_runtimes, dir, options);
+} catch (const GAPException& exp) {
+  ErrorMayQuit(exp.what(), 0, 0);
+}
+return Fail;
+}
+
+Obj FuncDIFF_PROFILES(Obj self, Obj before, Obj after)
+{
+try {
+    return diffProfiles(before, after);
+} catch (const GAPException& exp) {
+  ErrorMayQuit(exp.what(), 0, 0);
+}
+return Fail;
+}
+
+Obj FuncPROFILE_RUN_STATS(Obj self, Obj baseline, Obj candidate)
+{
+try {
+    return profileRunStats(baseline, candidate);
+} catch (const GAPException& exp) {
+  ErrorMayQuit(exp.what(), 0, 0);
+}
+return Fail;
+}
+
+Obj FuncPROFILE_BUDGET_MEASURES(Obj self, Obj profile, Obj budgets)
+{
+try {
+    return profileBudgetMeasures(profile, budgets);
+} catch (const GAPException& exp) {
+  ErrorMayQuit(exp.what(), 0, 0);
+}
+return Fail;
+}
+
+Obj FuncWRITE_CALLGRIND_PROFILE(Obj self, Obj profile, Obj filename)
+{
+try {
+    if(!IS_STRING(filename)) {
+      ErrorMayQuit("Filename must be a string", 0, 0);
+    }
+    Obj filenamestr = CopyToStringRep(filename);
+    FILE* out = fopen(CSTR_STRING(filenamestr), "w");
+    if(!out) {
+      ErrorMayQuit("Unable to open file %s", (Int)CSTR_STRING(filenamestr), 0);
+      return Fail;
+    }
+    try {
+      writeCallgrind(out, profile);
+    } catch (const GAPException&) {
+      fclose(out);
+      throw;
+    }
+    if(fclose(out) != 0)
+      throw GAPException("Unable to write profile");
+    return True;
+} catch (const GAPException& exp) {
+  ErrorMayQuit(exp.what(), 0, 0);
+}
+return Fail;
+}
+
+Obj FuncWRITE_PPROF_PROFILE(Obj self, Obj profile, Obj filename)
+{
+try {
+    if(!IS_STRING(filename)) {
+      ErrorMayQuit("Filename must be a string", 0, 0);
+    }
+    Obj filenamestr = CopyToStringRep(filename);
+    std::string encoded = encodePprof(profile);
+    // pprof expects profiles to be gzipped
+    OutStream out(CSTR_STRING(filenamestr), true);
+    if(out.fail()) {
+      ErrorMayQuit("Unable to open file %s", (Int)CSTR_STRING(filenamestr), 0);
+      return Fail;
+    }
+    size_t written = fwrite(encoded.data(), 1, encoded.size(), out.stream);
+    if(!out.close() || written != encoded.size()) {
+      ErrorMayQuit("Unable to write file %s", (Int)CSTR_STRING(filenamestr), 0);
+      return Fail;
+    }
+    return True;
+} catch (const GAPException& exp) {
+  ErrorMayQuit(exp.what(), 0, 0);
+}
+return Fail;
+}
+
+Obj FuncWRITE_COVERAGE_PAGES(Obj self, Obj pages, Obj options)
+{
+try {
+    return writeCoveragePages(pages, options);
+} catch (const GAPException& exp) {
+  ErrorMayQuit(exp.what(), 0, 0);
+}
+return Fail;
+}
+
+Obj FuncWRITE_LCOV_COVERAGE(Obj self, Obj line_info, Obj filename)
+{
+try {
+    return writeLcovCoverage(line_info, filename);
+} catch (const GAPException& exp) {
+  ErrorMayQuit(exp.what(), 0, 0);
+}
+return Fail;
+}
+
+Obj FuncWRITE_JSON_COVERAGE(Obj self, Obj line_info, Obj filename)
+{
+try {
+    return writeJsonCoverage(line_info, filename);
+} catch (const GAPException& exp) {
+  ErrorMayQuit(exp.what(), 0, 0);
+}
+return Fail;
+}
+
+Obj FuncWRITE_COVERALLS_COVERAGE(Obj self, Obj line_info, Obj filename, Obj options)
+{
+try {
+    return writeCoverallsCoverage(line_info, filename, options);
+} catch (const GAPException& exp) {
+  ErrorMayQuit(exp.what(), 0, 0);
+}
+return Fail;
+}
+
 Obj FuncHTMLEncodeString(Obj self, Obj param)
 {
   if(!IS_STRING_REP(param))
@@ -545,116 +1720,89 @@ Obj FuncHTMLEncodeString(Obj self, Obj param)
   }
 
   Int len = GET_LEN_STRING(param);
-  // Make long enough there is no chance a
-  // resize will be needed. - 8 * 6 to allow for tabs
-  Obj outstring = NEW_STRING(len * 8 * 6);
-  char* ptr = CSTR_STRING(param);
-  char* outptr = CSTR_STRING(outstring);
-  Int outpos = 0;
-  for(Int i = 0; i < len; ++i)
-  {
-    switch(ptr[i]) {
-      case '&':
-        outptr[outpos++] = '&';
-        outptr[outpos++] = 'a';
-        outptr[outpos++] = 'm';
-        outptr[outpos++] = 'p';
-        outptr[outpos++] = ';';
-        break;
-      case '<':
-        outptr[outpos++] = '&';
-        outptr[outpos++] = 'l';
-        outptr[outpos++] = 't';
-        outptr[outpos++] = ';';
-        break;
-      case ' ':
-        outptr[outpos++] = '&';
-        outptr[outpos++] = 'n';
-        outptr[outpos++] = 'b';
-        outptr[outpos++] = 's';
-        outptr[outpos++] = 'p';
-        outptr[outpos++] = ';';
-        break;
-      case '\t':
-        for(int i = 0; i < 8; ++i) {
-          outptr[outpos++] = '&';
-          outptr[outpos++] = 'n';
-          outptr[outpos++] = 'b';
-          outptr[outpos++] = 's';
-          outptr[outpos++] = 'p';
-          outptr[outpos++] = ';';
-        }
-        break;
-      default:
-        outptr[outpos++] = ptr[i];
-    }
-  }
-  SET_LEN_STRING(outstring, outpos);
-  SHRINK_STRING(outstring);
+  Obj outstring = NEW_STRING(htmlEncodedLength(CSTR_STRING(param), len));
+  // NEW_STRING can cause a garbage collection, so find 'param' again
+  htmlEncodeInto(CSTR_STRING(outstring), CSTR_STRING(param), len);
   return outstring;
 }
 
-Obj FuncMD5File(Obj self, Obj filename)
+// Encode a list of strings (such as the lines of a file) into one string
+Obj FuncHTMLEncodeLines(Obj self, Obj lines)
 {
-  if (!IsStringConv(filename))
+  if(!IS_SMALL_LIST(lines))
   {
-    ErrorQuit("MD5File: <filename> must be a string", 0, 0);
+    ErrorMayQuit("<lines> must be a list of strings",0L,0L);
   }
 
-  MD5Context ctx;
-
-  MD5Init(&ctx);
-
-  int fd = open(CSTR_STRING(filename), O_RDONLY);
-  if (fd < 0)
+  Int count = LEN_LIST(lines);
+  size_t total = 0;
+  for(Int i = 1; i <= count; ++i)
   {
-    ErrorQuit("MD5File: failed to open file %g", (Int)filename, 0);
+    Obj line = ELM_LIST(lines, i);
+    if(!IS_STRING_REP(line))
+    {
+      ErrorMayQuit("<lines> must be a list of strings",0L,0L);
+    }
+    total += htmlEncodedLength(CSTR_STRING(line), GET_LEN_STRING(line));
   }
 
-  // get the file length
-  struct stat sb;
-  if (fstat(fd, &sb) == -1 || sb.st_size < 0)
+  Obj outstring = NEW_STRING(total);
+  char* outptr = CSTR_STRING(outstring);
+  for(Int i = 1; i <= count; ++i)
   {
-    close(fd);
-    ErrorQuit("MD5File: failed to determine size of file %g", (Int)filename, 0);
+    Obj line = ELM_LIST(lines, i);
+    outptr = htmlEncodeInto(outptr, CSTR_STRING(line), GET_LEN_STRING(line));
   }
-  off_t len = sb.st_size;
+  return outstring;
+}
 
-  while (len > 0)
+Obj FuncMD5File(Obj self, Obj filename)
+{
+  if (!IsStringConv(filename))
   {
-    uint8_t buffer[4096];
-    size_t amount = (len < 4096 ? len : 4096);
-    ssize_t bytesRead = read(fd, buffer, amount);
-    if (bytesRead < 0) {
-      close(fd);
-      ErrorQuit("MD5File: error reading from file %g", (Int)filename, 0);
-    }
-    MD5Update(&ctx, buffer, (size_t)bytesRead);
-    len -= bytesRead;
+    ErrorQuit("MD5File: <filename> must be a string", 0, 0);
   }
 
-  close(fd);
-
-  uint8_t digest[16];
-  MD5Final(digest, &ctx);
-
-  char str[33];
-  static const char hex[] = "0123456789abcdef";
-  for (int i = 0; i < 16; i++)
-  {
-    str[2*i] = hex[digest[i] >> 4];
-    str[2*i + 1] = hex[digest[i] & 0x0f];
-  }
-  str[32] = '\0';
+try {
+    SourceCacheGuard guard;
+    return MakeImmString(sourceCache.get(CSTR_STRING(filename))->md5("MD5File").c_str());
+} catch (const GAPException& exp) {
+  ErrorMayQuit(exp.what(), 0, 0);
+}
+return Fail;
+}
 
-  return MakeImmString(str);
+Obj FuncMD5Files(Obj self, Obj filenames)
+{
+try {
+    return md5Files(filenames);
+} catch (const GAPException& exp) {
+  ErrorMayQuit(exp.what(), 0, 0);
+}
+return Fail;
 }
 
 // Table of functions to export
 static StructGVarFunc GVarFuncs [] = {
     GVAR_FUNC_2ARGS(READ_PROFILE_FROM_STREAM, param, param2),
+    GVAR_FUNC_1ARGS(SQUASH_STACK_RUNTIMES, stack_runtimes),
+    GVAR_FUNC_2ARGS(WRITE_FLAME_GRAPHS, stack_runtimes, graphs),
+    GVAR_FUNC_3ARGS(WRITE_FOLDED_STACKS, stack_runtimes, filename, options),
+    GVAR_FUNC_3ARGS(WRITE_FLAME_GRAPH_DATA, stack_runtimes, dir, options),
+    GVAR_FUNC_2ARGS(WRITE_DIFF_FLAME_GRAPH, stacks, options),
+    GVAR_FUNC_2ARGS(DIFF_PROFILES, before, after),
+    GVAR_FUNC_2ARGS(PROFILE_RUN_STATS, baseline, candidate),
+    GVAR_FUNC_2ARGS(PROFILE_BUDGET_MEASURES, profile, budgets),
+    GVAR_FUNC_2ARGS(WRITE_CALLGRIND_PROFILE, profile, filename),
+    GVAR_FUNC_2ARGS(WRITE_PPROF_PROFILE, profile, filename),
+    GVAR_FUNC_2ARGS(WRITE_COVERAGE_PAGES, pages, options),
+    GVAR_FUNC_2ARGS(WRITE_LCOV_COVERAGE, line_info, filename),
+    GVAR_FUNC_2ARGS(WRITE_JSON_COVERAGE, line_info, filename),
+    GVAR_FUNC_3ARGS(WRITE_COVERALLS_COVERAGE, line_info, filename, options),
     GVAR_FUNC_1ARGS(HTMLEncodeString, param),
+    GVAR_FUNC_1ARGS(HTMLEncodeLines, lines),
     GVAR_FUNC_1ARGS(MD5File, filename),
+    GVAR_FUNC_1ARGS(MD5Files, filenames),
 
 	{ 0 } /* Finish with an empty entry */
 };
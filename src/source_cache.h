@@ -0,0 +1,388 @@
+//  Please refer to the COPYRIGHT file of the profiling package for details.
+//  SPDX-License-Identifier: MIT
+/*
+ * A cache of the source files named in a profile, used while writing a
+ * report: the coverage pages, the lcov, JSON and coveralls exports, and
+ * MD5File and MD5Files. Each file is opened and mapped into memory at most
+ * once, when its contents are first needed, and the start of each line and
+ * the hashes of the file are only worked out when first asked for. Files
+ * which can not be read, such as *stdin*, are handled here, so every report
+ * treats them the same way.
+ *
+ * A file which changes on disk is read again, so the cache is never out of
+ * date. Each kernel function which writes a report holds a
+ * SourceCacheGuard, which empties the cache when it returns (or fails), so
+ * no file is kept mapped between reports.
+ *
+ * This file is included into profiling.cc, after work_queue.h.
+ */
+
+#ifndef PROFILING_SOURCE_CACHE_H
+#define PROFILING_SOURCE_CACHE_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+
+// A fast 64-bit hash, used to notice when a file or page changes. This is
+// not a cryptographic hash (MD5File is still there for that), but reads 8
+// bytes at a time, so is much cheaper.
+struct FastHash
+{
+  uint64_t h;
+
+  FastHash() : h(0x243F6A8885A308D3ULL)
+  { }
+
+  void mix(uint64_t w)
+  {
+    h ^= w;
+    h *= 0x9E3779B97F4A7C15ULL;
+    h ^= h >> 29;
+  }
+
+  void add(const char* p, size_t len)
+  {
+    mix(len);
+    size_t i = 0;
+    for(; i + 8 <= len; i += 8)
+    {
+      uint64_t w;
+      memcpy(&w, p + i, 8);
+      mix(w);
+    }
+    uint64_t w = 0;
+    memcpy(&w, p + i, len - i);
+    mix(w);
+  }
+
+  void add(const std::string& s)
+  { add(s.data(), s.size()); }
+
+  void add(Int n)
+  { mix((uint64_t)n); }
+
+  // The hash, with its bits mixed together as in MurmurHash3
+  uint64_t value() const
+  {
+    uint64_t v = h;
+    v ^= v >> 33;
+    v *= 0xFF51AFD7ED558CCDULL;
+    v ^= v >> 33;
+    v *= 0xC4CEB9FE1A85EC53ULL;
+    v ^= v >> 33;
+    return v;
+  }
+};
+
+// One source file. It is only opened when its contents are first needed,
+// so checking that a file exists costs one stat. Once read, the contents
+// never change, and the lazily built parts are guarded by 'lock', so it
+// can be used from any thread.
+class SourceFile
+{
+  std::string filename;
+  // Did stat find the file?
+  bool present_;
+  // Has the file been opened, and was all of it read?
+  bool loaded;
+  bool opened;
+  bool found;
+  const char* data;
+  size_t size;
+
+  // How the file looked when it was read, to notice when it changes
+  struct stat info;
+  // The mapping of the file, or 0 if it was read into 'contents'
+  void* mapped;
+  std::string contents;
+
+  pthread_mutex_t lock;
+  // The offset of the start of each line, and the end of the file
+  bool indexed;
+  std::vector<size_t> line_starts;
+  bool fast_hashed;
+  uint64_t fast_hash;
+  std::string md5_hex;
+
+  SourceFile(const SourceFile&);
+  void operator=(const SourceFile&);
+
+  // Read the file from 'fd' when it can not be mapped
+  bool readAll(int fd)
+  {
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    char buf[65536];
+    ssize_t len;
+    while((len = read(fd, buf, sizeof(buf))) > 0)
+      contents.append(buf, len);
+    return len == 0;
+  }
+
+  // Map or read the file, the first time it is needed. 'lock' must be held.
+  void load()
+  {
+    if(loaded)
+      return;
+    loaded = true;
+    if(!present_)
+      return;
+
+    int fd = open(filename.c_str(), O_RDONLY);
+    if(fd < 0)
+      return;
+    opened = true;
+    struct stat now;
+    if(fstat(fd, &now) == 0 && S_ISREG(now.st_mode) && now.st_size > 0)
+    {
+      info = now;
+      void* map = mmap(0, now.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if(map != MAP_FAILED)
+      {
+#ifdef MADV_SEQUENTIAL
+        // Files are almost always read from start to end
+        madvise(map, now.st_size, MADV_SEQUENTIAL);
+#endif
+        mapped = map;
+        data = (const char*)map;
+        size = now.st_size;
+        found = true;
+      }
+    }
+    if(!found && readAll(fd))
+    {
+      data = contents.data();
+      size = contents.size();
+      found = true;
+    }
+    close(fd);
+  }
+
+  void buildIndex()
+  {
+    const char* p = data;
+    const char* end = data + size;
+    while(p < end)
+    {
+      line_starts.push_back(p - data);
+      const char* newline = (const char*)memchr(p, '\n', end - p);
+      p = newline ? newline + 1 : end;
+    }
+    line_starts.push_back(size);
+    indexed = true;
+  }
+
+public:
+  // 'st' is the result of stat on 'filename', or 0 if that failed
+  SourceFile(const std::string& _filename, const struct stat* st)
+    : filename(_filename), present_(st != 0), loaded(false), opened(false),
+      found(false), data(""), size(0), mapped(0), indexed(false),
+      fast_hashed(false), fast_hash(0)
+  {
+    pthread_mutex_init(&lock, 0);
+    memset(&info, 0, sizeof(info));
+    if(st)
+      info = *st;
+  }
+
+  ~SourceFile()
+  {
+    if(mapped)
+      munmap(mapped, size);
+    pthread_mutex_destroy(&lock);
+  }
+
+  // Does 'st' (or 0, if stat failed) describe the file this was read from?
+  bool unchanged(const struct stat* st) const
+  {
+    if(!st)
+      return !present_;
+    return present_ && st->st_dev == info.st_dev && st->st_ino == info.st_ino &&
+           st->st_size == info.st_size && st->st_mtime == info.st_mtime;
+  }
+
+  // True if there is a file (or directory) called 'filename', as with
+  // IsExistingFile. This does not open the file.
+  bool present() const
+  { return present_; }
+
+  // False if the file does not exist, or can not be read
+  bool exists()
+  {
+    pthread_mutex_lock(&lock);
+    load();
+    pthread_mutex_unlock(&lock);
+    return found;
+  }
+
+  // The number of lines, counting a last line with no newline
+  size_t lineCount()
+  {
+    pthread_mutex_lock(&lock);
+    load();
+    if(!indexed)
+      buildIndex();
+    pthread_mutex_unlock(&lock);
+    return line_starts.size() - 1;
+  }
+
+  // Line 'i' (counting from 1) including its newline, as GAP's ReadLine
+  // returns it. lineCount must be called first.
+  const char* line(size_t i, size_t& len) const
+  {
+    len = line_starts[i] - line_starts[i - 1];
+    return data + line_starts[i - 1];
+  }
+
+  // A hash of the contents, which is also different for a missing file and
+  // an empty one
+  uint64_t fastHash()
+  {
+    pthread_mutex_lock(&lock);
+    load();
+    if(!fast_hashed)
+    {
+      FastHash hash;
+      hash.add((Int)found);
+      hash.add(data, size);
+      fast_hash = hash.value();
+      fast_hashed = true;
+    }
+    uint64_t h = fast_hash;
+    pthread_mutex_unlock(&lock);
+    return h;
+  }
+
+  // The MD5 digest of the contents, in hex. If the file can not be read,
+  // throws an exception whose message starts with 'caller'.
+  std::string md5(const char* caller)
+  {
+    pthread_mutex_lock(&lock);
+    load();
+    if(!found)
+    {
+      pthread_mutex_unlock(&lock);
+      throw GAPException(std::string(caller) +
+                         (opened ? ": error reading from file " : ": failed to open file ") +
+                         filename);
+    }
+    if(md5_hex.empty())
+    {
+      MD5Context ctx;
+      MD5Init(&ctx);
+      // MD5Update only takes an unsigned length
+      for(size_t pos = 0; pos < size; pos += (1 << 30))
+        MD5Update(&ctx, (const uint8_t*)data + pos, std::min(size - pos, (size_t)(1 << 30)));
+      uint8_t digest[16];
+      MD5Final(digest, &ctx);
+      static const char hex[] = "0123456789abcdef";
+      for(int i = 0; i < 16; i++)
+      {
+        md5_hex += hex[digest[i] >> 4];
+        md5_hex += hex[digest[i] & 0x0f];
+      }
+    }
+    std::string h = md5_hex;
+    pthread_mutex_unlock(&lock);
+    return h;
+  }
+};
+
+class SourceCache
+{
+  std::map<std::string, SourceFile*> files;
+  // Files which changed on disk and were read again. They are kept until
+  // the cache is cleared, as another thread may still be using them.
+  std::vector<SourceFile*> replaced;
+  pthread_mutex_t lock;
+
+public:
+  SourceCache()
+  { pthread_mutex_init(&lock, 0); }
+
+  ~SourceCache()
+  {
+    clear();
+    pthread_mutex_destroy(&lock);
+  }
+
+  SourceFile* get(const std::string& filename)
+  {
+    struct stat st;
+    bool have_stat = stat(filename.c_str(), &st) == 0;
+    pthread_mutex_lock(&lock);
+    SourceFile*& file = files[filename];
+    if(file && !file->unchanged(have_stat ? &st : 0))
+    {
+      replaced.push_back(file);
+      file = 0;
+    }
+    if(!file)
+      file = new SourceFile(filename, have_stat ? &st : 0);
+    SourceFile* ret = file;
+    pthread_mutex_unlock(&lock);
+    return ret;
+  }
+
+  void clear()
+  {
+    pthread_mutex_lock(&lock);
+    for(std::map<std::string, SourceFile*>::iterator it = files.begin(); it != files.end(); ++it)
+      delete it->second;
+    for(size_t i = 0; i < replaced.size(); ++i)
+      delete replaced[i];
+    files.clear();
+    replaced.clear();
+    pthread_mutex_unlock(&lock);
+  }
+};
+
+static SourceCache sourceCache;
+
+// Empties the cache when it goes out of scope
+struct SourceCacheGuard
+{
+  ~SourceCacheGuard()
+  { sourceCache.clear(); }
+};
+
+// Finds the MD5 digest of each file on its own thread. The caller must
+// hold a SourceCacheGuard.
+struct MD5Queue : public WorkQueue
+{
+  const std::vector<std::string>& filenames;
+  std::vector<std::string> digests;
+
+  MD5Queue(const std::vector<std::string>& _filenames)
+    : filenames(_filenames), digests(_filenames.size())
+  { }
+
+  void job(size_t index)
+  { digests[index] = sourceCache.get(filenames[index])->md5("MD5Files"); }
+};
+
+// The MD5 digest of each file in the list 'filenames', as given by MD5File,
+// found in parallel
+static Obj md5Files(Obj filenames)
+{
+  SourceCacheGuard guard;
+  if(!IS_SMALL_LIST(filenames))
+    throw GAPException("MD5Files: <filenames> must be a list of strings");
+  std::vector<std::string> names;
+  for(Int i = 1; i <= LEN_LIST(filenames); ++i)
+  {
+    Obj name = ELM_LIST(filenames, i);
+    if(!IsStringConv(name))
+      throw GAPException("MD5Files: <filenames> must be a list of strings");
+    names.push_back(CSTR_STRING(name));
+  }
+
+  MD5Queue queue(names);
+  queue.run(names.size(), 0);
+  return GAP_make(queue.digests);
+}
+
+#endif
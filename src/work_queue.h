@@ -0,0 +1,104 @@
+//  Please refer to the COPYRIGHT file of the profiling package for details.
+//  SPDX-License-Identifier: MIT
+/*
+ * Run a job for each of a list of items on several threads. GAP is not
+ * thread safe, so jobs must not use it: everything they need is copied out
+ * of GAP first, and their results are made into GAP objects once every job
+ * is done.
+ *
+ * This file is included into profiling.cc, after html_encode.h.
+ */
+
+#ifndef PROFILING_WORK_QUEUE_H
+#define PROFILING_WORK_QUEUE_H
+
+#include <pthread.h>
+#include <unistd.h>
+
+class WorkQueue
+{
+  size_t count;
+  size_t next;
+  pthread_mutex_t lock;
+  // The error from the job for each item, or "" if it worked
+  std::vector<std::string> errors;
+
+  WorkQueue(const WorkQueue&);
+  void operator=(const WorkQueue&);
+
+  // Returns false once every item has been taken
+  bool take(size_t& index)
+  {
+    pthread_mutex_lock(&lock);
+    index = next;
+    if(next < count)
+      next++;
+    pthread_mutex_unlock(&lock);
+    return index < count;
+  }
+
+  void runJobs()
+  {
+    size_t index;
+    while(take(index))
+    {
+      try {
+        job(index);
+      } catch (const std::exception& e) {
+        errors[index] = e.what();
+      }
+    }
+  }
+
+  static void* runThread(void* queue)
+  {
+    ((WorkQueue*)queue)->runJobs();
+    return 0;
+  }
+
+protected:
+  // Do the job for item 'index', throwing an exception if it fails
+  virtual void job(size_t index) = 0;
+
+public:
+  WorkQueue() : count(0), next(0)
+  { pthread_mutex_init(&lock, 0); }
+
+  virtual ~WorkQueue()
+  { pthread_mutex_destroy(&lock); }
+
+  // Run the jobs for items 0 to 'items' - 1 on 'threads' threads (0 for one
+  // per processor). Once they are all done, throws the error of the first
+  // item which failed.
+  void run(size_t items, Int threads)
+  {
+    count = items;
+    next = 0;
+    errors.assign(items, std::string());
+
+    if(threads <= 0)
+      threads = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = std::min(threads, (Int)items);
+
+    std::vector<pthread_t> workers;
+    for(Int i = 1; i < threads; ++i)
+    {
+      pthread_t t;
+      if(pthread_create(&t, 0, runThread, this) != 0)
+        break;
+      workers.push_back(t);
+    }
+    // This thread also runs jobs, so we are fine if no threads started
+    runJobs();
+    for(size_t i = 0; i < workers.size(); ++i)
+      pthread_join(workers[i], 0);
+
+    for(size_t i = 0; i < errors.size(); ++i)
+    {
+      if(!errors[i].empty())
+        throw GAPException(errors[i]);
+    }
+  }
+};
+
+#endif
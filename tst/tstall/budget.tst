@@ -0,0 +1,32 @@
+gap> START_TEST("budget.tst");
+gap> IsLineByLineProfileActive();
+false
+gap> LoadPackage("IO", false);
+true
+gap> LoadPackage("profiling", false);
+true
+gap> dir := DirectoryTemporary();;
+gap> file := Filename(dir, "budget.gz");;
+gap> leaf := function() return 1; end;;
+gap> g := function() local i; for i in [1..3] do leaf(); od; end;;
+gap> ProfileLineByLine(file);
+true
+gap> g();
+gap> UnprofileLineByLine();
+true
+gap> AssertProfileBudget(file, rec(function := "leaf", max_calls := 3));
+[  ]
+gap> v := AssertProfileBudget(file, [rec(function := "leaf", max_calls := 2),
+>                                    rec(file := "*", max_share := 2)]);;
+gap> List(v, x -> [x.limit, x.maximum, x.value]);
+[ [ "max_calls", 2, 3 ] ]
+gap> AssertProfileBudget(file, rec(function := "nothere", max_incl_ticks := 0));
+[  ]
+gap> v := AssertProfileBudget(file, rec(file := "*", max_self_ticks := -1));;
+gap> Length(v) = 1 and v[1].value >= 0;
+true
+gap> AssertProfileBudget(file, rec(function := "leaf", max_time := 3));
+Error, AssertProfileBudget: unknown budget component 'max_time'
+gap> AssertProfileBudget(file, rec(function := "leaf", file := "*"));
+Error, Each budget must have exactly one of 'function' and 'file'
+gap> STOP_TEST("budget.tst", 1);
@@ -0,0 +1,33 @@
+gap> START_TEST("callgraph.tst");
+gap> IsLineByLineProfileActive();
+false
+gap> LoadPackage("IO", false);
+true
+gap> LoadPackage("profiling", false);
+true
+gap> dir := DirectoryTemporary();;
+gap> file := Filename(dir, "cheese.gz");;
+gap> leaf := function() return 1; end;;
+gap> g := function() local i; for i in [1..3] do leaf(); od; end;;
+gap> ProfileLineByLine(file);
+true
+gap> g();
+gap> UnprofileLineByLine();
+true
+gap> x := ReadLineByLineProfile(file);;
+gap> ForAny(x.call_graph.edges, e -> e[1] > 0 and e[3] = 3);
+true
+gap> ForAll(x.call_graph.edges, e -> Length(e) = 5 and e[4] >= e[5]);
+true
+gap> Sum(x.call_graph.edges, e -> e[5]) = Sum(x.stack_runtimes, s -> s[2]) - x.stack_runtimes[1][2];
+true
+gap> ForAll([1..Length(x.line_function_calls)], f ->
+>      List(x.line_function_calls[f][2], Length) = List(x.line_function_call_stats[f][2], Length));
+true
+gap> Length(x.function_durations) = Length(x.functions);
+true
+gap> ForAll(x.function_durations, d -> d[2] <= d[3] and d[3] <= d[4] and d[4] <= d[5]);
+true
+gap> ForAny(x.function_durations, d -> d[1] = 3);
+true
+gap> STOP_TEST("callgraph.tst", 1);
@@ -0,0 +1,32 @@
+gap> START_TEST("callgrind.tst");
+gap> IsLineByLineProfileActive();
+false
+gap> LoadPackage("IO", false);
+true
+gap> LoadPackage("profiling", false);
+true
+gap> dir := DirectoryTemporary();;
+gap> file := Filename(dir, "cheese.gz");;
+gap> leaf := function() return 1; end;;
+gap> g := function() local i; for i in [1..3] do leaf(); od; end;;
+gap> ProfileLineByLine(file);
+true
+gap> g();
+gap> UnprofileLineByLine();
+true
+gap> x := ReadLineByLineProfile(file);;
+gap> out := Filename(dir, "callgrind.out");;
+gap> OutputCallgrindProfile(x, out);
+gap> str := StringFile(out);;
+gap> StartsWith(str, "# callgrind format\n");
+true
+gap> PositionSublist(str, "\nevents: Ticks Execs\n") <> fail;
+true
+gap> PositionSublist(str, "\ncalls=3 ") <> fail;
+true
+gap> PositionSublist(str, "\ntotals: ") <> fail;
+true
+gap> OutputCallgrindProfile(file, out);
+gap> StringFile(out) = str;
+true
+gap> STOP_TEST("callgrind.tst", 1);
@@ -29,4 +29,31 @@ gap> OutputAnnotatedCodeCoverageFiles(x, Filename(dir, "outdir2"));
 # use the --prof/--cover command line options
 gap> IsReadableFile(Filename(dir, "outdir2/index.html"));
 true
+gap> IsReadableFile(Filename(dir, "outdir2/flame-default-standard.svg"));
+true
+gap> page := Concatenation("outdir2/",
+>      ReplacedString(Filename(testdir, "testcode2.g"), "/", "_"), ".html");;
+gap> page := StringFile(Filename(dir, page));;
+gap> PositionSublist(page, "<tr class='exec'>") <> fail;
+true
+gap> PositionSublist(page, "<a name=\"line20\"></a>20</td><td><span><tt>g(-2);\n</tt>") <> fail;
+true
+gap> PositionSublist(page, "</tbody>\n</table></body></html>\n") <> fail;
+true
+gap> ForAll(x.stack_runtimes, s -> Length(s) = 3 and s[2] = 0);
+true
+gap> calls := Sum(x.stack_runtimes, s -> s[3]);;
+gap> calls > 0;
+true
+gap> svg := OutputFlameGraph(x, rec(weight := "calls"));;
+gap> PositionSublist(svg, Concatenation("all (", String(calls), " calls, 100.00%)")) <> fail;
+true
+gap> folded := SplitString(OutputFlameGraphInput(x, rec(weight := "calls")), "\n");;
+gap> Sum(folded, l -> Int(SplitString(l, " ")[Length(SplitString(l, " "))])) = calls;
+true
+gap> OutputFlameGraph(x, rec(weight := "time"));
+Error, Invalid options.weight in FlameGraph config: time
+gap> m := MergeLineByLineProfiles([x, x]);;
+gap> Sum(m.stack_runtimes, s -> s[3]) = 2 * calls;
+true
 gap> STOP_TEST("genprof.tst", 1);
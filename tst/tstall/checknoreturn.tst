@@ -18,7 +18,9 @@ gap> UnprofileLineByLine();
 true
 gap> x := ReadLineByLineProfile(file);;
 gap> SortedList(RecNames(x)) = 
-> [ "info", "line_calling_function_calls", "line_function_calls", "line_info", "stack_runtimes" ];
+> [ "call_graph", "function_durations", "functions", "info",
+>   "line_calling_function_calls", "line_function_call_stats", "line_function_calls",
+>   "line_info", "stack_runtimes" ];
 true
 gap> filenames := List(x.line_info, y -> y[1]);;
 gap> file := Filtered(filenames, x -> EndsWith(x, "testcodenoreturn.g"));;
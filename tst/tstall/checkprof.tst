@@ -29,4 +29,22 @@ true
 gap> OutputFlameGraph(x, Filename(dir, "flame2"));
 gap> IsReadableFile(Filename(dir, "flame2"));
 true
+gap> leaf := function(n) local i, s; s := 0; for i in [1..n] do s := s + i; od; return s; end;;
+gap> twice := function(n) return leaf(n) + leaf(n); end;;
+gap> file := Filename(dir, "percall.gz");;
+gap> ProfileLineByLine(file);
+true
+gap> twice(100000);;
+gap> twice(100000);;
+gap> UnprofileLineByLine();
+true
+gap> x := ReadLineByLineProfile(file);;
+gap> stacks := Filtered(x.stack_runtimes, s -> ForAny(s[1], f -> f.name = "twice"));;
+gap> ticks := Sum(stacks, s -> s[2]);;
+gap> First(stacks, s -> s[1][Length(s[1])].name = "twice")[3];
+2
+gap> folded := SplitString(OutputFlameGraphInput(x, rec(weight := "ticks_per_call")), "\n");;
+gap> folded := Filtered(folded, l -> PositionSublist(l, "twice@") <> fail);;
+gap> Sum(folded, l -> Int(SplitString(l, " ")[Length(SplitString(l, " "))])) = QuoInt(ticks + 1, 2);
+true
 gap> STOP_TEST("genprof.tst", 1);
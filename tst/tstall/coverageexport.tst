@@ -0,0 +1,27 @@
+gap> START_TEST("coverageexport.tst");
+gap> dir := DirectoryTemporary();;
+gap> sample := Filename(DirectoriesPackageLibrary("profiling", "tst/tstall"), "md5.sample");;
+gap> data := rec(line_info := [[sample, [[1, 2, 0, 0], [1, 0, 0, 0], [0, 0, 0, 0]]],
+>                              ["*stdin*", [[1, 1, 0, 0]]]]);;
+gap> OutputLcovCoverage(data, Filename(dir, "lcov.info"));
+gap> StringFile(Filename(dir, "lcov.info")) =
+>    Concatenation("TN:\nSF:", sample, "\nDA:1,2\nDA:2,0\nend_of_record\n");
+true
+gap> OutputJsonCoverage(data, Filename(dir, "codecov.json"));
+gap> StringFile(Filename(dir, "codecov.json")) =
+>    Concatenation("{ \"coverage\": {\n\"", sample, "\": {\n\"1\": \"1\",\n\"2\": \"0\"}\n} }");
+true
+gap> OutputJsonCoverage(data, Filename(dir, "codecov.json.gz"));
+gap> StringFile(Filename(dir, "codecov.json.gz")) = StringFile(Filename(dir, "codecov.json"));
+true
+gap> OutputCoverallsJsonCoverage(data, Filename(dir, "coveralls.json"),
+>    sample{[1..Length(sample) - Length("md5.sample")]}, rec(service_name := "test"));
+gap> StringFile(Filename(dir, "coveralls.json")) = Concatenation(
+>    "{\n\"service_name\": \"test\",\n\"source_files\": [\n",
+>    "{\n\"name\": \"md5.sample\",\n",
+>    "\"source_digest\": \"91785c4eeb49934bdaef739a6e2a2710\",\n",
+>    "\"coverage\": [2, 0, null]\n}\n] }");
+true
+gap> OutputLcovCoverage(data, "/nonexistent/dir/lcov.info");
+Error, Unable to open file /nonexistent/dir/lcov.info
+gap> STOP_TEST("coverageexport.tst", 1);
@@ -0,0 +1,73 @@
+gap> START_TEST("diff.tst");
+gap> IsLineByLineProfileActive();
+false
+gap> LoadPackage("IO", false);
+true
+gap> LoadPackage("profiling", false);
+true
+gap> dir := DirectoryTemporary();;
+gap> file1 := Filename(dir, "before.gz");;
+gap> file2 := Filename(dir, "after.gz");;
+gap> f := function(n) local i, s; s := 0; for i in [1..n] do s := s + i; od; return s; end;;
+gap> ProfileLineByLine(file1);
+true
+gap> f(1000);;
+gap> UnprofileLineByLine();
+true
+gap> ProfileLineByLine(file2);
+true
+gap> f(100000);;
+gap> UnprofileLineByLine();
+true
+gap> diff := DiffLineByLineProfiles(file1, file2);;
+gap> SortedList(RecNames(diff));
+[ "functions", "lines", "stacks" ]
+gap> ForAll(diff.functions, r -> r.incl_before >= r.self_before and r.incl_after >= r.self_after);
+true
+gap> deltas := List(diff.functions, r -> r.incl_after - r.incl_before);;
+gap> deltas = SortedList(deltas, {a, b} -> a > b);
+true
+gap> Sum(diff.stacks, s -> s.after) = Sum(ReadLineByLineProfile(file2).stack_runtimes, s -> s[2]);
+true
+gap> same := DiffLineByLineProfiles(file1, file1);;
+gap> ForAll(same.functions, r -> r.self_before = r.self_after and r.incl_before = r.incl_after);
+true
+gap> funcs := Filename(dir, "funcs.g");;
+gap> PrintTo(funcs, "fs := [\n",
+>   "function(n) local i, s; s := 0; for i in [1..n] do s := s + i; od; return s; end,\n",
+>   "function(n) local i, s; s := 0; for i in [1..n] do s := s + i; od; return s; end];\n");
+gap> Read(funcs);
+gap> ProfileLineByLine(file1);
+true
+gap> fs[1](100000);;
+gap> fs[2](100000);;
+gap> UnprofileLineByLine();
+true
+gap> PrintTo(funcs, "fs := [\n\n\n",
+>   "function(n) local i, s; s := 0; for i in [1..n] do s := s + i; od; return s; end];\n");
+gap> Read(funcs);
+gap> ProfileLineByLine(file2);
+true
+gap> fs[1](100000);;
+gap> UnprofileLineByLine();
+true
+gap> moved := DiffLineByLineProfiles(file1, file2);;
+gap> nameless := Filtered(moved.functions, r -> r.function.filename = funcs);;
+gap> List(nameless, r -> r.function.name);
+[ "nameless", "nameless" ]
+gap> SortedList(List(nameless, r -> r.function.line));
+[ 3, 4 ]
+gap> Number(nameless, r -> r.incl_after > 0);
+1
+gap> OutputDiffFlameGraph(diff, Filename(dir, "diff.svg"));
+gap> IsReadableFile(Filename(dir, "diff.svg"));
+true
+gap> svg := OutputDiffFlameGraph(diff);;
+gap> PositionSublist(svg, "Differential Flame Graph") <> fail;
+true
+gap> OutputDiffFlameGraph(diff, "/nonexistent/dir/diff.svg");
+Error, Unable to open file /nonexistent/dir/diff.svg
+gap> OutputDiffRegressionTable(diff, Filename(dir, "diff.html"));
+gap> IsReadableFile(Filename(dir, "diff.html"));
+true
+gap> STOP_TEST("diff.tst", 1);
@@ -18,3 +18,16 @@ gap> HTMLEncodeString("\t");
 "&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;"
 gap> HTMLEncodeString(" &<a &<b&< c");
 "&nbsp;&amp;&lt;a&nbsp;&amp;&lt;b&amp;&lt;&nbsp;c"
+gap> HTMLEncodeString("a_long_line_with_no_spaces_which_needs_no_encoding<at_all");
+"a_long_line_with_no_spaces_which_needs_no_encoding&lt;at_all"
+gap> HTMLEncodeString(Concatenation(ListWithIdenticalEntries(40, 'x'), "\t&"));
+"xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&amp;"
+gap> HTMLEncodeLines([]);
+""
+gap> HTMLEncodeLines(["if x < 1 then\n", "\treturn;\n", "", "fi;"]);
+"if&nbsp;x&nbsp;&lt;&nbsp;1&nbsp;then\n&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;return;\nfi;"
+gap> lines := List([0..40], i -> Concatenation(ListWithIdenticalEntries(i, 'a'), " &<\t\n"));;
+gap> HTMLEncodeLines(lines) = Concatenation(List(lines, HTMLEncodeString));
+true
+gap> HTMLEncodeLines([1]);
+Error, <lines> must be a list of strings
@@ -35,7 +35,64 @@ gap> IsReadableFile(Filename(dir, "outdir3/index.html"));
 true
 gap> PositionSublist(StringFile(Filename(dir, "outdir3/index.html")), "mytitle") <> fail;
 true
+gap> OutputAnnotatedCodeCoverageFiles(x, Filename(dir, "outdir4"), rec(title := "mytitle", threads := 1));
+gap> ForAll(Concatenation(["index.html"],
+>     List(x.line_info, f -> Concatenation(ReplacedString(ReplacedString(f[1], "/", "_"), "*", "_"), ".html"))),
+>     f -> StringFile(Filename(dir, Concatenation("outdir3/", f))) =
+>          StringFile(Filename(dir, Concatenation("outdir4/", f))));
+true
+gap> OutputAnnotatedCodeCoverageFiles(x, Filename(dir, "outdir4"), rec(threads := 0));
+Error, options.threads must be a positive integer
+gap> IsReadableFile(Filename(dir, "outdir4/coverage-manifest.txt"));
+true
+gap> page := Concatenation("outdir4/",
+>     ReplacedString(ReplacedString(x.line_info[1][1], "/", "_"), "*", "_"), ".html");;
+gap> FileString(Filename(dir, page), "unchanged");;
+gap> OutputAnnotatedCodeCoverageFiles(x, Filename(dir, "outdir4"), rec(title := "mytitle"));
+gap> StringFile(Filename(dir, page));
+"unchanged"
+gap> OutputAnnotatedCodeCoverageFiles(x, Filename(dir, "outdir4"), rec(title := "other"));
+gap> StringFile(Filename(dir, page)) = StringFile(Filename(dir, ReplacedString(page, "outdir4", "outdir3")));
+false
+gap> FileString(Filename(dir, page), "unchanged");;
+gap> OutputAnnotatedCodeCoverageFiles(x, Filename(dir, "outdir4"), rec(title := "mytitle", incremental := false));
+gap> StringFile(Filename(dir, page)) = StringFile(Filename(dir, ReplacedString(page, "outdir4", "outdir3")));
+true
+gap> OutputAnnotatedCodeCoverageFiles(x, Filename(dir, "outdir4"), rec(incremental := 1));
+Error, options.incremental must be true or false
+gap> OutputAnnotatedCodeCoverageFiles(x, Filename(dir, "outdir5"), rec(virtual := true));
+gap> IsReadableFile(Filename(dir, "outdir5/coveragepage.js"));
+true
+gap> page := ReplacedString(page, "outdir4", "outdir5");;
+gap> PositionSublist(StringFile(Filename(dir, page)), "<script src=\"coveragepage.js\">") <> fail;
+true
+gap> StartsWith(StringFile(Filename(dir, Concatenation(page, ".js"))), "coveragePage({");
+true
+gap> OutputAnnotatedCodeCoverageFiles(x, Filename(dir, "outdir5"), rec(virtual := 1));
+Error, options.virtual must be true or false
 gap> OutputFlameGraph(x, Filename(dir, "flame2"));
 gap> IsReadableFile(Filename(dir, "flame2"));
 true
+gap> IsReadableFile(Filename(dir, "flame2.tmp"));
+false
+gap> svg := OutputFlameGraph(x, rec(minwidth := 5, title := "<mine>"));;
+gap> PositionSublist(svg, "&lt;mine&gt;") <> fail;
+true
+gap> PositionSublist(svg, ">Search</text>") <> fail;
+true
+gap> Length(svg) <= Length(OutputFlameGraph(x));
+true
+gap> folded := OutputFlameGraphInput(x);;
+gap> Sum(SplitString(folded, "\n"), l -> Int(SplitString(l, " ")[Length(SplitString(l, " "))]))
+>    = Sum(x.stack_runtimes, s -> s[2]);
+true
+gap> OutputFlameGraphInput(x, Filename(dir, "folded.gz"));
+gap> IsReadableFile(Filename(dir, "folded.gz"));
+true
+gap> IsReadableFile(Filename(dir, "outdir/flame-canvas/index.html"));
+true
+gap> OutputFlameGraphHTML(x, Filename(dir, "canvas"), rec(chunk_nodes := 2));
+gap> ForAll(["index.html", "data.js", "flamegraph.js", "chunks/1.js"],
+>           f -> IsReadableFile(Filename(dir, Concatenation("canvas/", f))));
+true
 gap> STOP_TEST("genprof.tst", 1);
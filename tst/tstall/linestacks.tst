@@ -0,0 +1,38 @@
+gap> START_TEST("linestacks.tst");
+gap> IsLineByLineProfileActive();
+false
+gap> LoadPackage("IO", false);
+true
+gap> LoadPackage("profiling", false);
+true
+gap> dir := DirectoryTemporary();;
+gap> file := Filename(dir, "lines.gz");;
+gap> leaf := function() return 1; end;;
+gap> g := function()
+>   local i;
+>   for i in [1..3] do leaf(); od;
+>   for i in [1..2] do leaf(); od;
+> end;;
+gap> ProfileLineByLine(file);
+true
+gap> g();
+gap> UnprofileLineByLine();
+true
+gap> x := ReadLineByLineProfile(file, rec(line_stacks := true));;
+gap> Sum(x.line_stack_runtimes, s -> s[2]) = Sum(x.stack_runtimes, s -> s[2]);
+true
+gap> leaves := Set(Filtered(Concatenation(List(x.line_stack_runtimes, s -> s[1])),
+>                           f -> StartsWith(f.name, "leaf [from ")), f -> f.name);;
+gap> Length(leaves);
+2
+gap> IsBound(ReadLineByLineProfile(file).line_stack_runtimes);
+false
+gap> folded := OutputFlameGraphInput(file, rec(lines := true));;
+gap> PositionSublist(folded, "leaf [from ") <> fail;
+true
+gap> OutputFlameGraph(x, Filename(dir, "lines.svg"), rec(lines := true));
+gap> IsReadableFile(Filename(dir, "lines.svg"));
+true
+gap> OutputFlameGraph(ReadLineByLineProfile(file), rec(lines := true));
+Error, Option 'lines' needs a profile read with 'line_stacks'
+gap> STOP_TEST("linestacks.tst", 1);
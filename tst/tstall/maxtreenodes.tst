@@ -0,0 +1,39 @@
+gap> START_TEST("maxtreenodes.tst");
+gap> IsLineByLineProfileActive();
+false
+gap> LoadPackage("IO", false);
+true
+gap> LoadPackage("profiling", false);
+true
+gap> dir := DirectoryTemporary();;
+gap> file := Filename(dir, "cheese.gz");;
+gap> testdir:= DirectoriesPackageLibrary( "profiling", "tst" )[1];;
+gap> Read(Filename(testdir, "testcode1.g"));
+gap> ProfileLineByLine(file);
+true
+gap> Read(Filename(testdir, "testcode2.g"));
+gap> f(1);;
+gap> UnprofileLineByLine();
+true
+gap> x := ReadLineByLineProfile(file);;
+gap> x.info.reader_stats.pruned_nodes;
+0
+gap> x.info.reader_stats.tree_nodes = Length(x.stack_runtimes) - 1;
+true
+gap> y := ReadLineByLineProfile(file, rec(max_tree_nodes := 10));;
+gap> y.info.reader_stats.pruned_nodes > 0;
+true
+gap> Length(y.stack_runtimes) < Length(x.stack_runtimes);
+true
+gap> Sum(y.stack_runtimes, s -> s[2]) = Sum(x.stack_runtimes, s -> s[2]);
+true
+gap> ForAny(y.stack_runtimes, s -> ForAny(s[1], f -> f.name = "[other]"));
+true
+gap> y.line_info = x.line_info;
+true
+gap> OutputFlameGraph(y, Filename(dir, "flame"));
+gap> IsReadableFile(Filename(dir, "flame"));
+true
+gap> ReadLineByLineProfile(file, rec(max_tree_nodes := -1));
+Error, max_tree_nodes must be a positive integer
+gap> STOP_TEST("maxtreenodes.tst", 1);
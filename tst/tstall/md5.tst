@@ -6,4 +6,21 @@ Error, MD5File: failed to open file DOES_NOT_EXIST
 gap> filename := Filename(DirectoriesPackageLibrary("profiling", "tst/tstall"), "md5.sample");;
 gap> MD5File(filename);
 "91785c4eeb49934bdaef739a6e2a2710"
+gap> MD5File(filename);
+"91785c4eeb49934bdaef739a6e2a2710"
+gap> tmpfile := Filename(DirectoryTemporary(), "md5.tmp");;
+gap> FileString(tmpfile, "");;
+gap> MD5File(tmpfile);
+"d41d8cd98f00b204e9800998ecf8427e"
+gap> FileString(tmpfile, "abc");;
+gap> MD5File(tmpfile);
+"900150983cd24fb0d6963f7d28e17f72"
+gap> MD5Files([filename, tmpfile, filename]) = List([filename, tmpfile, filename], MD5File);
+true
+gap> MD5Files([]);
+[  ]
+gap> MD5Files([filename, "DOES_NOT_EXIST"]);
+Error, MD5Files: failed to open file DOES_NOT_EXIST
+gap> MD5Files(fail);
+Error, MD5Files: <filenames> must be a list of strings
 gap> STOP_TEST("md5.tst", 1);
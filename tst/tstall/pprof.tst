@@ -0,0 +1,51 @@
+gap> START_TEST("pprof.tst");
+gap> IsLineByLineProfileActive();
+false
+gap> LoadPackage("IO", false);
+true
+gap> LoadPackage("profiling", false);
+true
+gap> dir := DirectoryTemporary();;
+gap> file := Filename(dir, "cheese.gz");;
+gap> f := function(n) local i, s; s := 0; for i in [1..n] do s := s + i; od; return s; end;;
+gap> ProfileLineByLine(file);
+true
+gap> f(1000);;
+gap> UnprofileLineByLine();
+true
+gap> x := ReadLineByLineProfile(file);;
+gap> out := Filename(dir, "profile.pb.gz");;
+gap> OutputPprofProfile(x, out);
+gap> str := StringFile(out);;
+gap> List(str{[1,2]}, IntChar);
+[ 31, 139 ]
+gap> OutputPprofProfile(file, out);
+gap> IsReadableFile(out);
+true
+gap> memfile := Filename(dir, "memory.gz");;
+gap> ProfileLineByLine(memfile, rec(recordMem := true));
+true
+gap> f(1000);;
+gap> UnprofileLineByLine();
+true
+gap> OutputPprofProfile(memfile, out);
+gap> IsReadableFile(out);
+true
+gap> testdir:= DirectoriesPackageLibrary( "profiling", "tst" )[1];;
+gap> linefile := Filename(dir, "lines.gz");;
+gap> ProfileLineByLine(linefile);
+true
+gap> Read(Filename(testdir, "testcode1.g"));
+gap> f(1);;
+gap> UnprofileLineByLine();
+true
+gap> y := ReadLineByLineProfile(linefile, rec(line_stacks := true));;
+gap> Sum(y.line_samples, s -> s[2]) = Sum(y.stack_runtimes, s -> s[2]);
+true
+gap> ForAny(y.line_samples, s -> ForAny(s[1], l -> l[2] = 15 and
+>      PositionSublist(l[1].filename, "testcode1.g") <> fail));
+true
+gap> OutputPprofProfile(y, out);
+gap> IsReadableFile(out);
+true
+gap> STOP_TEST("pprof.tst", 1);
@@ -0,0 +1,41 @@
+gap> START_TEST("readerstats.tst");
+gap> IsLineByLineProfileActive();
+false
+gap> LoadPackage("IO", false);
+true
+gap> LoadPackage("profiling", false);
+true
+gap> dir := DirectoryTemporary();;
+gap> file := Filename(dir, "cheese.gz");;
+gap> testdir:= DirectoriesPackageLibrary( "profiling", "tst" )[1];;
+gap> Read(Filename(testdir, "testcode1.g"));
+gap> ProfileLineByLine(file);
+true
+gap> Read(Filename(testdir, "testcode2.g"));
+gap> f(1);;
+gap> UnprofileLineByLine();
+true
+gap> x := ReadLineByLineProfile(file);;
+gap> s := x.info.reader_stats;;
+gap> s.info_records;
+1
+gap> s.damaged_lines;
+0
+gap> s.into_fun_records > 0 and s.out_fun_records > 0;
+true
+gap> s.max_stack_depth > 0;
+true
+gap> s.lines = s.read_records + s.exec_records + s.into_fun_records +
+>              s.out_fun_records + s.string_id_records + s.info_records;
+true
+gap> ForAll([s.loop_ns, s.build_ns, s.convert_ns], t -> IsInt(t) and t >= 0);
+true
+gap> [s.read_ns, s.parse_ns, s.aggregate_ns];
+[ 0, 0, 0 ]
+gap> s := ReadLineByLineProfile(file, rec(phase_timing := true)).info.reader_stats;;
+gap> ForAll([s.loop_ns, s.read_ns, s.parse_ns, s.aggregate_ns],
+>           t -> IsInt(t) and t >= 0);
+true
+gap> s.read_ns + s.parse_ns + s.aggregate_ns <= s.loop_ns;
+true
+gap> STOP_TEST("readerstats.tst", 1);
@@ -0,0 +1,39 @@
+gap> START_TEST("runstats.tst");
+gap> IsLineByLineProfileActive();
+false
+gap> LoadPackage("IO", false);
+true
+gap> LoadPackage("profiling", false);
+true
+gap> dir := DirectoryTemporary();;
+gap> f := function(n) local i, s; s := 0; for i in [1..n] do s := s + i; od; return s; end;;
+gap> runs := function(name, n)
+>   local files, i, file;
+>   files := [];
+>   for i in [1..3] do
+>     file := Filename(dir, Concatenation(name, String(i), ".gz"));
+>     ProfileLineByLine(file);
+>     f(n);
+>     UnprofileLineByLine();
+>     Add(files, file);
+>   od;
+>   return files;
+> end;;
+gap> small := runs("small", 1000);;
+gap> large := runs("large", 200000);;
+gap> stats := LineByLineProfileStatistics(small);;
+gap> stats.baseline_runs;
+3
+gap> ForAll(stats.functions, r -> r.self.sd >= 0 and r.incl.ci >= 0 and r.incl.mean >= r.self.mean);
+true
+gap> cmp := CompareLineByLineProfileRuns(small, large);;
+gap> [cmp.baseline_runs, cmp.candidate_runs];
+[ 3, 3 ]
+gap> ForAny(cmp.functions, r -> r.incl_significant and r.incl_change > 0);
+true
+gap> same := CompareLineByLineProfileRuns(small, small);;
+gap> ForAny(same.functions, r -> r.incl_significant or r.self_significant);
+false
+gap> LineByLineProfileStatistics([]);
+Error, Profiles must be given as a non-empty list
+gap> STOP_TEST("runstats.tst", 1);
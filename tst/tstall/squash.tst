@@ -0,0 +1,34 @@
+gap> START_TEST("squash.tst");
+gap> IsLineByLineProfileActive();
+false
+gap> LoadPackage("IO", false);
+true
+gap> LoadPackage("profiling", false);
+true
+gap> dir := DirectoryTemporary();;
+gap> file := Filename(dir, "cheese.gz");;
+gap> fact := function(n) if n <= 1 then return 1; fi; return n * fact(n-1); end;;
+gap> ProfileLineByLine(file);
+true
+gap> fact(20);;
+gap> UnprofileLineByLine();
+true
+gap> x := ReadLineByLineProfile(file);;
+gap> y := ReadLineByLineProfile(file, rec(squash := true));;
+gap> z := SquashLineByLineProfile(x);;
+gap> y.stack_runtimes = z.stack_runtimes;
+true
+gap> SquashLineByLineProfile(file).stack_runtimes = z.stack_runtimes;
+true
+gap> Length(z.stack_runtimes) < Length(x.stack_runtimes);
+true
+gap> Sum(z.stack_runtimes, s -> s[2]) = Sum(x.stack_runtimes, s -> s[2]);
+true
+gap> ForAll(z.stack_runtimes, s -> ForAll([2..Length(s[1])], i -> s[1][i] <> s[1][i-1]));
+true
+gap> z.line_info = x.line_info;
+true
+gap> OutputFlameGraph(x, Filename(dir, "flame"), rec(squash := true));
+gap> IsReadableFile(Filename(dir, "flame"));
+true
+gap> STOP_TEST("squash.tst", 1);
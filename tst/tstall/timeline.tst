@@ -0,0 +1,46 @@
+gap> START_TEST("timeline.tst");
+gap> IsLineByLineProfileActive();
+false
+gap> LoadPackage("IO", false);
+true
+gap> LoadPackage("profiling", false);
+true
+gap> dir := DirectoryTemporary();;
+gap> file := Filename(dir, "cheese.gz");;
+gap> testdir:= DirectoriesPackageLibrary( "profiling", "tst" )[1];;
+gap> Read(Filename(testdir, "testcode1.g"));
+gap> ProfileLineByLine(file);
+true
+gap> Read(Filename(testdir, "testcode2.g"));
+gap> f(1);;
+gap> f(-1);;
+gap> UnprofileLineByLine();
+true
+gap> x := ReadLineByLineProfile(file);;
+gap> IsBound(x.timeline);
+false
+gap> x := ReadLineByLineProfile(file, rec(timeline_ticks := 1000));;
+gap> t := x.timeline;;
+gap> t.bucket_ticks;
+1000
+gap> Length(t.functions) = Length(t.function_ticks);
+true
+gap> Length(t.files) = Length(t.file_ticks);
+true
+gap> ForAll(Concatenation(t.function_ticks, t.file_ticks), r -> Length(r) = t.buckets);
+true
+gap> Sum(t.file_ticks, Sum) = Sum(x.line_info, f -> Sum(f[2], l -> l[3]));
+true
+gap> ReadLineByLineProfile(file, rec(timeline_ticks := 0));
+Error, timeline_ticks must be a positive integer
+gap> memfile := Filename(dir, "memory.gz");;
+gap> ProfileLineByLine(memfile, rec(recordMem := true));
+true
+gap> f(1);;
+gap> UnprofileLineByLine();
+true
+gap> ReadLineByLineProfile(memfile, rec(timeline_ticks := 1000)).timeline.bucket_ticks;
+1000
+gap> ReadLineByLineProfile(memfile, rec(timeline_seconds := 1));
+Error, timeline_seconds can not be used with a profile of memory use
+gap> STOP_TEST("timeline.tst", 1);
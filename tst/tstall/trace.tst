@@ -0,0 +1,33 @@
+gap> START_TEST("trace.tst");
+gap> IsLineByLineProfileActive();
+false
+gap> LoadPackage("IO", false);
+true
+gap> LoadPackage("profiling", false);
+true
+gap> dir := DirectoryTemporary();;
+gap> file := Filename(dir, "cheese.gz");;
+gap> f := function(n) local i, s; s := 0; for i in [1..n] do s := s + i; od; return s; end;;
+gap> g := function() local i; for i in [1..10] do f(10000); od; end;;
+gap> ProfileLineByLine(file);
+true
+gap> g();
+gap> UnprofileLineByLine();
+true
+gap> tracefile := Filename(dir, "trace.json");;
+gap> x := ReadLineByLineProfile(file, rec(trace_file := tracefile, trace_min_ticks := 1));;
+gap> str := StringFile(tracefile);;
+gap> StartsWith(str, "{\"traceEvents\":[");
+true
+gap> x.info.reader_stats.trace_events > 0;
+true
+gap> x.info.reader_stats.trace_events mod 2;
+0
+gap> Number(str, c -> c = '{') = 1 + 3 * x.info.reader_stats.trace_events / 2;
+true
+gap> y := ReadLineByLineProfile(file, rec(trace_file := tracefile, trace_min_ticks := 10^15));;
+gap> y.info.reader_stats.trace_events;
+0
+gap> ReadLineByLineProfile(file, rec(trace_file := tracefile));
+Error, trace_min_ticks must be given with trace_file
+gap> STOP_TEST("trace.tst", 1);